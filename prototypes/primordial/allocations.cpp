@@ -0,0 +1,35 @@
+#include <cstdlib>
+#include <new>
+#include "allocations.hpp"
+
+// The replacements live in their own translation unit, so they are not
+// inlined into new and delete expressions. GCC would then see memory from
+// operator new given to free, and warn with -Wmismatched-new-delete.
+
+static thread_local Primordial::Allocations allocations;
+
+void *operator new(std::size_t size) {
+	++allocations.count;
+	allocations.bytes += size;
+	if (void *p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+	std::free(p);
+}
+
+namespace Primordial {
+
+	auto thread_allocations() -> Allocations {
+		return allocations;
+	}
+
+} // namespace Primordial
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Primordial {
+
+	// Heap allocations made through operator new, which every program that
+	// links allocations.cpp counts. The array and sized forms of operator
+	// new end up there too.
+	struct Allocations {
+		std::size_t count = 0;
+		std::size_t bytes = 0;
+	};
+
+	// Allocations made by the calling thread so far. The counters are per
+	// thread, so parallel parses can measure their own allocations.
+	auto thread_allocations() -> Allocations;
+
+} // namespace Primordial
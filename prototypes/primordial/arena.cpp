@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <cstdint>
+#include "arena.hpp"
+
+namespace Primordial {
+
+	// Small enough not to matter for tiny files, large enough to keep the
+	// number of chunks low on big ones since every chunk doubles the size.
+	static constexpr std::size_t initial_chunk_size = 64 * 1024;
+
+	Arena::Arena() : chunk_size_(initial_chunk_size) {}
+
+	Arena::~Arena() = default;
+
+	void* Arena::allocate(std::size_t size, std::size_t alignment) {
+		auto addr = reinterpret_cast<std::uintptr_t>(next_);
+		auto aligned = (addr + alignment - 1) & ~(alignment - 1);
+		auto padding = aligned - addr;
+
+		auto available = static_cast<std::size_t>(limit_ - next_);
+		if (next_ == nullptr || padding + size > available) {
+			grow(size + alignment);
+			addr = reinterpret_cast<std::uintptr_t>(next_);
+			aligned = (addr + alignment - 1) & ~(alignment - 1);
+			padding = aligned - addr;
+		}
+
+		void *p = next_ + padding;
+		next_ += padding + size;
+		return p;
+	}
+
+	auto Arena::copy(std::string_view s) -> std::string_view {
+		if (s.empty()) {
+			return {};
+		}
+
+		auto *p = static_cast<char *>(allocate(s.size(), 1));
+		std::memcpy(p, s.data(), s.size());
+		return std::string_view(p, s.size());
+	}
+
+	void Arena::grow(std::size_t min_size) {
+		std::size_t size = std::max(chunk_size_, min_size);
+		chunks_.emplace_back(new std::byte[size]);
+		next_ = chunks_.back().get();
+		limit_ = next_ + size;
+		chunk_size_ *= 2;
+	}
+
+} // namespace Primordial
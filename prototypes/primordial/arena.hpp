@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace Primordial {
+
+	// Bump allocator for data that is released all at once, such as the
+	// strings of an interner.
+	//
+	// Memory is requested in geometrically growing chunks and is released
+	// all at once when the arena is destroyed.
+	class Arena {
+	public:
+		Arena();
+		~Arena();
+
+		Arena(Arena const &) = delete;
+		Arena& operator=(Arena const &) = delete;
+
+		void* allocate(std::size_t size, std::size_t alignment);
+
+		// Copy a string into the arena.
+		auto copy(std::string_view s) -> std::string_view;
+
+	private:
+		void grow(std::size_t min_size);
+
+		std::vector<std::unique_ptr<std::byte[]>> chunks_;
+		std::size_t chunk_size_;
+		std::byte *next_ = nullptr;
+		std::byte *limit_ = nullptr;
+	};
+
+} // namespace Primordial
@@ -1,475 +1,228 @@
+#include <algorithm>
+#include <array>
 #include <stdexcept>
 #include "ast.hpp"
 
 namespace AST {
 
-	void indent(std::ostream &os, int level) {
-		for (int i = 0; i < level; ++i) {
-			os << '\t';
-		}
-	}
-
+	// Indices must fit in 32 bits, and none is reserved.
 	template <typename T>
-	void print_list(
-		std::ostream &os,
-		int level,
-		std::vector<std::unique_ptr<T>> const &v
-	) {
-		bool first = true;
-		for (auto const &node : v) {
-			if (!first) {
-				os << ", ";
-			}
-
-			node->print(os, level);
-			first = false;
+	static auto next_index(std::vector<T> const &v) -> std::uint32_t {
+		if (v.size() >= none) {
+			throw std::length_error("syntax tree too large");
 		}
-	}
 
-	auto binary_operator_string(BinaryOperator op) -> std::string const & {
-		// Use static strings to minimise allocations.
-		// Use blocks to scope static variables to their point of use.
-		switch (op) {
-			case BinaryOperator::LOGICAL_OR: {
-				static std::string const logical_or("||");
-				return logical_or;
-			}
-			case BinaryOperator::LOGICAL_AND: {
-				static std::string const logical_and("&&");
-				return logical_and;
-			}
-			case BinaryOperator::EQ: {
-				static std::string const eq("==");
-				return eq;
-			}
-			case BinaryOperator::NE: {
-				static std::string const ne("!=");
-				return ne;
-			}
-			case BinaryOperator::LE: {
-				static std::string const le("<=");
-				return le;
-			}
-			case BinaryOperator::GE: {
-				static std::string const ge(">=");
-				return ge;
-			}
-			case BinaryOperator::LT: {
-				static std::string const lt("<");
-				return lt;
-			}
-			case BinaryOperator::GT: {
-				static std::string const gt(">");
-				return gt;
-			}
-			case BinaryOperator::ADD: {
-				static std::string const add("+");
-				return add;
-			}
-			case BinaryOperator::SUB: {
-				static std::string const sub("-");
-				return sub;
-			}
-			case BinaryOperator::BITWISE_OR: {
-				static std::string const bitwise_or("|");
-				return bitwise_or;
-			}
-			case BinaryOperator::BITWISE_XOR: {
-				static std::string const bitwise_xor("^");
-				return bitwise_xor;
-			}
-			case BinaryOperator::MUL: {
-				static std::string const mul("*");
-				return mul;
-			}
-			case BinaryOperator::DIV: {
-				static std::string const div("/");
-				return div;
-			}
-			case BinaryOperator::REM: {
-				static std::string const rem("%");
-				return rem;
-			}
-			case BinaryOperator::BITWISE_AND: {
-				static std::string const bitwise_and("&");
-				return bitwise_and;
-			}
-			case BinaryOperator::BITWISE_CLEAR: {
-				static std::string const bitwise_clear("&^");
-				return bitwise_clear;
-			}
-			case BinaryOperator::LEFT_SHIFT: {
-				static std::string const left_shift("<<");
-				return left_shift;
-			}
-			case BinaryOperator::RIGHT_SHIFT: {
-				static std::string const right_shift(">>");
-				return right_shift;
-			}
-		}
+		return static_cast<std::uint32_t>(v.size());
+	}
 
-		throw std::invalid_argument("unknown binary operator");
+	void Tree::complete(NodeId root) {
+		root_ = root;
+		scratch_ = {};
+		name_slots_ = {};
+		types_ = {};
+		type_lists_ = {};
+		array_sizes_ = {};
 	}
 
-	auto unary_operator_string(UnaryOperator op) {
-		// Use static strings to minimise allocations.
-		// Use blocks to scope static variables to their point of use.
-		switch (op) {
-			case UnaryOperator::NEG: {
-				static std::string const neg("-");
-				return neg;
-			}
-			case UnaryOperator::BITWISE_NOT: {
-				static std::string const bitwise_not("~");
-				return bitwise_not;
-			}
-			case UnaryOperator::LOGICAL_NOT: {
-				static std::string const logical_not("!");
-				return logical_not;
-			}
-			case UnaryOperator::ADDRESS_OF: {
-				static std::string const address_of("@");
-				return address_of;
+	void Tree::clear() {
+		// Only the slots of the names in the table are in use, and none
+		// once the tree is complete.
+		if (!name_slots_.empty()) {
+			for (auto name : names_) {
+				name_slots_[name.id()] = 0;
 			}
 		}
 
-		throw std::invalid_argument("unknown binary operator");
-	}
-
-	Node::~Node() = default;
-
-	TypeName::TypeName(std::string &&name) : name_(std::move(name)) {}
-
-	void TypeName::print(std::ostream &os, int level) const {
-		os << name_;
-	}
-
-	QualifiedTypeName::QualifiedTypeName(
-		std::string &&package,
-		std::string &&name
-	) : package_(std::move(package)), name_(std::move(name)) {}
-
-	void QualifiedTypeName::print(std::ostream &os, int level) const {
-		os << package_ << "." << name_;
-	}
-
-	ArrayType::ArrayType(
-		std::unique_ptr<Type> &&item_type,
-		std::unique_ptr<Expression> &&size
-	) : item_type_(std::move(item_type)), size_(std::move(size)) {}
-
-	void ArrayType::print(std::ostream &os, int level) const {
-		item_type_->print(os, level);
-		os << "[";
-		size_->print(os, level);
-		os << "]";
-	}
-
-	SliceType::SliceType(std::unique_ptr<Type> &&item_type)
-	: item_type_(std::move(item_type)) {}
-
-	void SliceType::print(std::ostream &os, int level) const {
-		item_type_->print(os, level);
-		os << "[]";
-	}
-
-	RawSliceType::RawSliceType(std::unique_ptr<Type> &&item_type)
-	: item_type_(std::move(item_type)) {}
-
-	void RawSliceType::print(std::ostream &os, int level) const {
-		item_type_->print(os, level);
-		os << "[_]";
-	}
-
-	PointerType::PointerType(std::unique_ptr<Type> &&item_type)
-	: item_type_(std::move(item_type)) {}
-
-	void PointerType::print(std::ostream &os, int level) const {
-		item_type_->print(os, level);
-		os << "?";
-	}
-
-	FunctionType::FunctionType(AST::TypeList &&inputs)
-	: inputs_(std::move(inputs)) {}
-
-	FunctionType::FunctionType(AST::TypeList &&inputs, AST::TypeList &&outputs)
-	: inputs_(std::move(inputs)), outputs_(std::move(outputs)) {}
-
-	void FunctionType::print(std::ostream &os, int level) const {
-		os << "func (";
-		print_list(os, level, inputs_);
-		os << ") -> (";
-		print_list(os, level, outputs_);
-		os << ")";
-	}
-
-	Field::Field() = default;
-
-	Field::Field(Field &&other) = default;
-
-	Field& Field::operator=(Field &&other)= default;
-
-	Field::Field(std::unique_ptr<Type> &&type)	: type_(std::move(type)) {}
-
-	Field::Field(std::string &&name, std::unique_ptr<Type> &&type)
-	: name_(std::move(name)), type_(std::move(type)) {}
-
-	void Field::print(std::ostream &os, int level) const {
-		indent(os, level);
-		if (!is_embedding()) {
-			os << name_ << ' ';
+		kinds_.clear();
+		operands_.clear();
+		operators_.clear();
+		names_.clear();
+		literals_.clear();
+		lists_.resize(1);
+		root_ = none;
+		types_.clear();
+		type_lists_.clear();
+		array_sizes_.clear();
+	}
+
+	auto Tree::add(
+		Kind kind,
+		std::uint32_t lhs,
+		std::uint32_t rhs
+	) -> NodeId {
+		auto id = next_index(kinds_);
+		kinds_.push_back(kind);
+		operands_.push_back({lhs, rhs});
+		operators_.push_back(0);
+		return id;
+	}
+
+	auto Tree::add(BinaryOperator op, NodeId lhs, NodeId rhs) -> NodeId {
+		auto id = add(Kind::BINARY_EXPRESSION, lhs, rhs);
+		operators_[id] = static_cast<std::uint8_t>(op);
+		return id;
+	}
+
+	auto Tree::add(UnaryOperator op, NodeId arg) -> NodeId {
+		auto id = add(Kind::UNARY_EXPRESSION, arg);
+		operators_[id] = static_cast<std::uint8_t>(op);
+		return id;
+	}
+
+	// Multiplicative mixing in the style of splitmix64, which is enough to
+	// spread small indices over the buckets.
+	static auto mix(std::uint64_t h, std::uint64_t x) -> std::uint64_t {
+		h = (h ^ x) * 0x9e3779b97f4a7c15;
+		return h ^ (h >> 32);
+	}
+
+	auto Tree::TypeKeyHash::operator()(TypeKey const &key) const
+		-> std::size_t {
+		auto h = mix(static_cast<std::uint64_t>(key.kind), key.lhs);
+		return mix(h, key.rhs);
+	}
+
+	auto Tree::add_type(
+		Kind kind,
+		std::uint32_t lhs,
+		std::uint32_t rhs
+	) -> NodeId {
+		switch (kind) {
+		case Kind::TYPE_INSTANTIATION:
+			rhs = canonical_list(rhs);
+			break;
+		case Kind::ARRAY_TYPE:
+			rhs = canonical_size(rhs);
+			break;
+		case Kind::FUNCTION_TYPE:
+			// The outputs are closed last, so they go first.
+			rhs = canonical_list(rhs);
+			lhs = canonical_list(lhs);
+			break;
+		default:
+			break;
 		}
 
-		type_->print(os, level);
-	}
-
-	bool Field::is_embedding() const {
-		return name_.empty();
-	}
-
-	StructType::StructType(FieldList &&fields) : fields_(std::move(fields)) {}
-
-	void StructType::print(std::ostream &os, int level) const {
-		os << "struct {\n";
-
-		for (auto const &field : fields_) {
-			field.print(os, level+1);
+		auto [it, inserted] = types_.try_emplace({kind, lhs, rhs}, 0);
+		if (inserted) {
+			it->second = add(kind, lhs, rhs);
 		}
 
-		os << "}\n";
+		return it->second;
 	}
 
-	UnionType::UnionType(FieldList &&fields) : fields_(std::move(fields)) {}
-
-	void UnionType::print(std::ostream &os, int level) const {
-		os << "union {\n";
-
-		for (auto const &field : fields_) {
-			field.print(os, level+1);
+	auto Tree::canonical_list(ListId id) -> ListId {
+		if (id == empty_list) {
+			return id;
 		}
 
-		os << "}\n";
-	}
-
-	void InterfaceType::print(std::ostream &os, int level) const {
-		// TODO
-	}
-
-	TypeInstantiation::TypeInstantiation(
-			std::unique_ptr<Type> &&generic_type,
-			std::vector<std::unique_ptr<Type>> &&args
-	) : generic_type_(std::move(generic_type)), args_(std::move(args)) {}
-
-	void TypeInstantiation::print(std::ostream &os, int level) const {
-		generic_type_->print(os, level);
-		os << "[";
-		print_list(os, level, args_);
-		os << "]";
-	}
-
-	BinaryExpression::BinaryExpression(
-		AST::BinaryOperator op,
-		std::unique_ptr<AST::Expression> &&lhs,
-		std::unique_ptr<AST::Expression> &&rhs
-	) : operator_(op), lhs_(std::move(lhs)), rhs_(std::move(rhs)) {}
-
-	void BinaryExpression::print(std::ostream &os, int level) const {
-		os << "(";
-		lhs_->print(os, level);
-		os << ") " << binary_operator_string(operator_) << " (";
-		rhs_->print(os, level);
-		os << ")";
-	}
-
-	UnaryExpression::UnaryExpression(
-		AST::UnaryOperator op,
-		std::unique_ptr<Expression> &&arg
-	) : operator_(op), arg_(std::move(arg)) {}
-
-	void UnaryExpression::print(std::ostream &os, int level) const {
-		os << unary_operator_string(operator_) << ' ';
-		arg_->print(os, level);
-	}
-
-	BooleanLiteral::BooleanLiteral(bool value) : value_(value) {}
-
-	void BooleanLiteral::print(std::ostream &os, int level) const {
-		if (value_) {
-			os << "true";
-		} else {
-			os << "false";
+		auto items = list(id);
+		std::uint64_t h = items.size();
+		for (auto item : items) {
+			h = mix(h, item);
 		}
-	}
-
-	StringLiteral::StringLiteral(std::string &&value)
-	: value_(std::move(value)) {}
-
-	void StringLiteral::print(std::ostream &os, int level) const {
-		os << value_;
-	}
-
-	NumericLiteral::NumericLiteral(std::string &&value)
-	: value_(std::move(value)) {}
-
-	void NumericLiteral::print(std::ostream &os, int level) const {
-		os << value_;
-	}
-
-	EmptyCompoundLiteral::EmptyCompoundLiteral(std::unique_ptr <Type> &&type)
-	: type_(std::move(type)) {}
-
-	void EmptyCompoundLiteral::print(std::ostream &os, int level) const {
-		type_->print(os, level);
-		os << " {}";
-	}
 
-	ListLiteral::ListLiteral(
-		std::unique_ptr<Type> &&type,
-		ExpressionList &&values
-	) : type_(std::move(type)), values_(std::move(values)) {}
+		auto [begin, end] = type_lists_.equal_range(h);
+		for (auto it = begin; it != end; ++it) {
+			if (std::ranges::equal(list(it->second), items)) {
+				if (id + items.size() + 1 == lists_.size()) {
+					lists_.resize(id);
+				}
 
-	void ListLiteral::print(std::ostream &os, int level) const {
-		type_->print(os, level);
-		os << " {";
-
-		for (auto const &value: values_) {
-			indent(os, level + 1);
-			value->print(os, level + 1);
-			os << '\n';
+				return it->second;
+			}
 		}
 
-		os << "};";
+		type_lists_.emplace(h, id);
+		return id;
 	}
 
-	FieldAssignment::FieldAssignment() {}
-
-	FieldAssignment::FieldAssignment(
-		std::string &&field,
-		std::unique_ptr<Expression> &&value
-	) : field_(std::move(field)), value_(std::move(value)) {}
-
-	void FieldAssignment::print(std::ostream &os, int level) const {
-		os << field_ << ": ";
-		value_->print(os, level);
-	}
-
-	RecordLiteral::RecordLiteral(
-		std::unique_ptr <Type> &&type,
-		AST::FieldAssignmentList &&assignments
-	) : type_(std::move(type)), assignments_(std::move(assignments)) {}
-
-	void RecordLiteral::print(std::ostream &os, int level) const {
-		os << "{\n";
-
-		for (auto const &assignment : assignments_) {
-			assignment.print(os, level+1);
-			os << ",\n";
+	auto Tree::canonical_size(NodeId id) -> NodeId {
+		// Other sizes are expressions, which are not hash-consed.
+		if (id == none || kind(id) != Kind::NUMERIC_LITERAL) {
+			return id;
 		}
 
-		indent(os, level);
-		os << "}";
-	}
-
-	ArrayAccess::ArrayAccess(
-		std::unique_ptr <Expression> &&array,
-		std::unique_ptr <Expression> index
-	) : array_(std::move(array)), index_(std::move(index)) {}
-
-	void ArrayAccess::print(std::ostream &os, int level) const {
-		array_->print(os, level);
-		os << '[';
-		index_->print(os, level);
-		os << ']';
-	}
-
-	FieldAccess::FieldAccess(
-		std::unique_ptr<Expression> &&record,
-		std::string &&field
-	) : record_(std::move(record)), field_(std::move(field)) {}
-
-	void FieldAccess::print(std::ostream &os, int level) const {
-		record_->print(os, level);
-		os << '.' << field_;
-	}
+		auto [it, inserted] = array_sizes_.try_emplace(literal(lhs(id)), id);
+		if (!inserted && id + 1 == kinds_.size()) {
+			if (lhs(id) + 1 == literals_.size()) {
+				literals_.pop_back();
+			}
 
-	PackageAccess::PackageAccess(std::string &&package, std::string &&name)
-	: package_(std::move(package)), name_(std::move(name)) {}
+			kinds_.pop_back();
+			operands_.pop_back();
+			operators_.pop_back();
+		}
 
-	void PackageAccess::print(std::ostream &os, int level) const {
-		os << package_ << '.' << name_;
+		return it->second;
 	}
 
-	SymbolAccess::SymbolAccess(std::string &&name) : name_(std::move(name)) {}
-
-	void SymbolAccess::print(std::ostream &os, int level) const {
-		os << name_;
-	}
+	auto Tree::add_name(InternedString name) -> std::uint32_t {
+		if (name.id() >= name_slots_.size()) {
+			name_slots_.resize(name.id() + 1);
+		}
 
-	PointerDereference::PointerDereference(std::unique_ptr<Expression> &&ptr)
-	: ptr_(std::move(ptr)) {}
+		auto &slot = name_slots_[name.id()];
+		if (slot == 0) {
+			names_.push_back(name);
+			slot = static_cast<std::uint32_t>(names_.size());
+		}
 
-	void PointerDereference::print(std::ostream &os, int level) const {
-		ptr_->print(os, level);
-		os << '.';
+		return slot - 1;
 	}
 
-	TypeCast::TypeCast(
-		std::unique_ptr<Type> &&type,
-		std::unique_ptr<Expression> &&expr
-	) : type_(std::move(type_)), expr_(std::move(expr)) {}
-
-	void TypeCast::print(std::ostream &os, int level) const {
-		type_->print(os, level);
-		os << '(';
-		expr_->print(os, level);
-		os << ')';
+	auto Tree::add_literal(std::string_view literal) -> std::uint32_t {
+		auto index = next_index(literals_);
+		literals_.push_back(literal);
+		return index;
 	}
 
-	File::File(
-		std::string &&name,
-		std::vector<Import> &&imports
-	) : name_(std::move(name)), imports_(std::move(imports)) {}
-
-	File::~File() = default;
-
-	void File::print(std::ostream &os, int level) const {
-		indent(os, level);
-		os << "package " << name_ << "\n\n";
-
-		if (imports_.size() == 1) {
-			imports_.at(0).print(os, level);
-			os << "\n";
-		} else if (imports_.size() > 1) {
-			for (auto const &import : imports_) {
-				import.print(os, level);
-			}
-
-			os << "\n";
+	auto Tree::close_list(std::uint32_t mark) -> ListId {
+		auto size = scratch_.size() - mark;
+		if (size == 0) {
+			return empty_list;
 		}
-	}
 
-	Import::Import() = default;
-
-	Import::Import(Import &&other) = default;
-
-	Import& Import::operator=(Import &&other) = default;
-
-	Import::Import(std::string &&path) : path_(path) {}
-
-	Import::Import(std::string &&path, std::string &&alias)
-	: path_(std::move(path)), alias_(std::move(alias)) {}
-
-	void Import::print(std::ostream &os, int level) const {
-		indent(os, level);
-		os << "import ";
+		auto id = next_index(lists_);
+		lists_.push_back(static_cast<NodeId>(size));
+		lists_.insert(lists_.end(), scratch_.begin() + mark, scratch_.end());
+		scratch_.resize(mark);
+		return id;
+	}
+
+	auto Tree::close_expression(std::uint32_t mark) -> NodeId {
+		// Operators waiting for their right operand, in increasing order
+		// of precedence, so there is at most one per level.
+		std::array<NodeId, precedence_levels> lhs;
+		std::array<BinaryOperator, precedence_levels> ops;
+		std::size_t pending = 0;
+
+		auto end = scratch_.size();
+		auto rhs = scratch_[mark];
+		for (auto i = mark + 1; i < end; i += 2) {
+			auto op = static_cast<BinaryOperator>(scratch_[i]);
+			while (pending > 0) {
+				if (precedence(ops[pending - 1]) < precedence(op)) {
+					break;
+				}
+
+				--pending;
+				rhs = add(ops[pending], lhs[pending], rhs);
+			}
+
+			lhs[pending] = rhs;
+			ops[pending] = op;
+			++pending;
+			rhs = scratch_[i + 1];
+		}
 
-		if (!alias_.empty()) {
-			os << alias_ << " ";
+		while (pending > 0) {
+			--pending;
+			rhs = add(ops[pending], lhs[pending], rhs);
 		}
 
-		os << path_ << "\n";
+		scratch_.resize(mark);
+		return rhs;
 	}
 
-	Import::~Import() {}
-
 } // namespace AST
@@ -1,152 +1,50 @@
 #pragma once
 
-#include <memory>
-#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
+#include "intern.hpp"
 
 namespace AST {
 
-	class Node {
-	public:
-		virtual ~Node();
-		virtual void print(std::ostream &os, int level) const = 0;
-	};
-
-	class Type : public Node {};
-	class Expression : public Node {};
-
-	using TypeList = std::vector<std::unique_ptr<Type>>;
-	using ExpressionList = std::vector<std::unique_ptr<Expression>>;
-
-	class TypeName : public Type {
-	public:
-		TypeName(std::string &&name);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::string name_;
-	};
-
-	class QualifiedTypeName : public Type {
-	public:
-		QualifiedTypeName(std::string &&package, std::string &&name);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::string package_;
-		std::string name_;
-	};
-
-	class TypeInstantiation : public Type {
-	public:
-		TypeInstantiation(
-			std::unique_ptr<Type> &&generic_type,
-			TypeList &&args
-		);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Type> generic_type_;
-		TypeList args_;
-	};
-
-	class ArrayType : public Type {
-	public:
-		ArrayType(
-			std::unique_ptr<Type> &&item_type,
-			std::unique_ptr<Expression> &&size
-		);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Type> item_type_;
-		std::unique_ptr<Expression> size_;
-	};
-
-	class SliceType : public Type {
-	public:
-		SliceType(std::unique_ptr<Type> &&item_type);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Type> item_type_;
-	};
-
-	class RawSliceType : public Type {
-	public:
-		RawSliceType(std::unique_ptr<Type> &&item_type);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Type> item_type_;
-	};
-
-	class PointerType : public Type {
-	public:
-		PointerType(std::unique_ptr<Type> &&item_type);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Type> item_type_;
-	};
-
-	class FunctionType : public Type {
-	public:
-		FunctionType(TypeList &&inputs);
-		FunctionType(TypeList &&inputs,TypeList &&outputs);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		TypeList inputs_;
-		TypeList outputs_;
-	};
-
-	class Field : public Node {
-	public:
-		Field(); // only for Bison
-		Field(Field &&other);
-		Field& operator=(Field &&other);
-
-		Field(std::unique_ptr<Type> &&type);
-		Field(std::string &&name, std::unique_ptr<Type> &&type);
-		void print(std::ostream &os, int level) const override final;
-		bool is_embedding() const;
-
-	private:
-		std::string name_;
-		std::unique_ptr<Type> type_;
-	};
-
-	using FieldList = std::vector<Field>;
-
-	class StructType : public Type {
-	public:
-		StructType(FieldList &&fields);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		FieldList fields_;
-	};
-
-	class UnionType : public Type {
-	public:
-		UnionType(FieldList &&fields);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		FieldList fields_;
-	};
-
-	class InterfaceType : public Type {
-	public:
-		InterfaceType() = default; // TODO replace
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		// TODO
-	};
-
-	enum class BinaryOperator {
+	using Primordial::InternedString;
+
+	enum class Kind : std::uint8_t {
+		TYPE_NAME,
+		QUALIFIED_TYPE_NAME,
+		TYPE_INSTANTIATION,
+		ARRAY_TYPE,
+		SLICE_TYPE,
+		RAW_SLICE_TYPE,
+		POINTER_TYPE,
+		FUNCTION_TYPE,
+		FIELD,
+		STRUCT_TYPE,
+		UNION_TYPE,
+		INTERFACE_TYPE,
+		BINARY_EXPRESSION,
+		UNARY_EXPRESSION,
+		BOOLEAN_LITERAL,
+		STRING_LITERAL,
+		NUMERIC_LITERAL,
+		EMPTY_COMPOUND_LITERAL,
+		LIST_LITERAL,
+		FIELD_ASSIGNMENT,
+		RECORD_LITERAL,
+		ARRAY_ACCESS,
+		FIELD_ACCESS,
+		PACKAGE_ACCESS,
+		SYMBOL_ACCESS,
+		POINTER_DEREFERENCE,
+		TYPE_CAST,
+		IMPORT,
+		FILE,
+	};
+
+	enum class BinaryOperator : std::uint8_t {
 		LOGICAL_OR,
 		LOGICAL_AND,
 		EQ,
@@ -168,215 +66,330 @@ namespace AST {
 		RIGHT_SHIFT,
 	};
 
-	class BinaryExpression : public Expression {
-	public:
-		BinaryExpression(
-			BinaryOperator op,
-			std::unique_ptr<Expression> &&lhs,
-			std::unique_ptr<Expression> &&rhs
-		);
+	// Binding power of the binary operators, indexed by operator. Higher
+	// binds tighter, and every level is left-associative.
+	inline constexpr std::uint8_t binary_precedence[] = {
+		1,                   // ||
+		2,                   // &&
+		3, 3, 3, 3, 3, 3,    // == != <= >= < >
+		4, 4, 4, 4,          // + - | ^
+		5, 5, 5, 5, 5, 5, 5, // * / % & &^ << >>
+	};
 
-		void print(std::ostream &os, int level) const override final;
+	inline constexpr std::size_t precedence_levels = 5;
 
-	private:
-		BinaryOperator operator_;
-		std::unique_ptr<Expression> lhs_, rhs_;
-	};
+	constexpr auto precedence(BinaryOperator op) -> std::uint8_t {
+		return binary_precedence[static_cast<std::size_t>(op)];
+	}
 
-	enum class UnaryOperator {
+	enum class UnaryOperator : std::uint8_t {
 		NEG,
 		BITWISE_NOT,
 		LOGICAL_NOT,
 		ADDRESS_OF,
 	};
 
-	class UnaryExpression : public Expression {
+	// Index of a node in its tree.
+	using NodeId = std::uint32_t;
+
+	// Index of a list of nodes in its tree.
+	using ListId = std::uint32_t;
+
+	// Missing node or name, e.g., the name of an embedded field.
+	inline constexpr std::uint32_t none = UINT32_MAX;
+
+	// A whole syntax tree stored in a handful of contiguous arrays.
+	//
+	// Every node has a kind and two 32-bit operands, kept in separate
+	// arrays, so a node takes 10 bytes and passes that only look at kinds
+	// touch one byte per node. Nodes refer to each other by index. Names
+	// and literals live in side tables, where every distinct name is only
+	// stored once. Lists of children are stored in a shared array,
+	// prefixed by their size. The meaning of the operands depends on the
+	// kind:
+	//
+	//   kind                     lhs               rhs
+	//
+	//   TYPE_NAME                name
+	//   QUALIFIED_TYPE_NAME      name (package)    name
+	//   TYPE_INSTANTIATION       node (type)       list (types)
+	//   ARRAY_TYPE               node (type)       node (size)
+	//   SLICE_TYPE               node (type)
+	//   RAW_SLICE_TYPE           node (type)
+	//   POINTER_TYPE             node (type)
+	//   FUNCTION_TYPE            list (inputs)     list (outputs)
+	//   FIELD                    name or none      node (type)
+	//   STRUCT_TYPE              list (fields)
+	//   UNION_TYPE               list (fields)
+	//   INTERFACE_TYPE
+	//   BINARY_EXPRESSION        node              node
+	//   UNARY_EXPRESSION         node
+	//   BOOLEAN_LITERAL          0 or 1
+	//   STRING_LITERAL           literal
+	//   NUMERIC_LITERAL          literal
+	//   EMPTY_COMPOUND_LITERAL   node (type)
+	//   LIST_LITERAL             node (type)       list (values)
+	//   FIELD_ASSIGNMENT         name              node (value)
+	//   RECORD_LITERAL           node (type)       list (assignments)
+	//   ARRAY_ACCESS             node (array)      node (index)
+	//   FIELD_ACCESS             node (record)     name
+	//   PACKAGE_ACCESS           name (package)    name
+	//   SYMBOL_ACCESS            name
+	//   POINTER_DEREFERENCE      node
+	//   TYPE_CAST                node (type)       node (expression)
+	//   IMPORT                   literal (path)    name (alias) or none
+	//   FILE                     name              list (imports)
+	//
+	// The operators of expressions are stored in a byte array of their
+	// own. Children that the grammar does not build yet are none.
+	//
+	// Type names, instantiations, arrays, slices, pointers and function
+	// types are hash-consed: each distinct type has a single node, shared
+	// by every place where it appears, so two such types are equal if and
+	// only if their indices are. Structs, unions and interfaces are
+	// always new nodes.
+	//
+	// The tree does not own any strings: names belong to the interner and
+	// literals point into the source text.
+	class Tree {
 	public:
-		UnaryExpression(UnaryOperator op, std::unique_ptr<Expression> &&arg);
-		void print(std::ostream &os, int level) const override final;
+		// Number of nodes.
+		auto size() const -> std::size_t {
+			return kinds_.size();
+		}
+
+		// The file node, or none if the tree is incomplete.
+		auto root() const -> NodeId {
+			return root_;
+		}
+
+		// Set the root and release the memory only needed to build the
+		// tree.
+		void complete(NodeId root);
+
+		// Drop every node, keeping the memory for the next ones. Lists
+		// that are still open are kept.
+		void clear();
+
+		auto kind(NodeId id) const -> Kind {
+			return kinds_[id];
+		}
+
+		auto lhs(NodeId id) const -> std::uint32_t {
+			return operands_[id].lhs;
+		}
+
+		auto rhs(NodeId id) const -> std::uint32_t {
+			return operands_[id].rhs;
+		}
+
+		auto binary_operator(NodeId id) const -> BinaryOperator {
+			return static_cast<BinaryOperator>(operators_[id]);
+		}
+
+		auto unary_operator(NodeId id) const -> UnaryOperator {
+			return static_cast<UnaryOperator>(operators_[id]);
+		}
+
+		auto name(std::uint32_t index) const -> InternedString {
+			return names_[index];
+		}
+
+		auto literal(std::uint32_t index) const -> std::string_view {
+			return literals_[index];
+		}
+
+		auto list(ListId id) const -> std::span<NodeId const> {
+			return {lists_.data() + id + 1, lists_[id]};
+		}
+
+		// Add a node and return its index.
+		auto add(Kind kind, std::uint32_t lhs = 0, std::uint32_t rhs = 0)
+			-> NodeId;
+		auto add(BinaryOperator op, NodeId lhs, NodeId rhs) -> NodeId;
+		auto add(UnaryOperator op, NodeId arg) -> NodeId;
+
+		// Add a hash-consed type node, or return the existing node of the
+		// same type. Its lists of types and its array size, if they were
+		// the last ones added, are dropped when the type already exists.
+		auto add_type(Kind kind, std::uint32_t lhs = 0, std::uint32_t rhs = 0)
+			-> NodeId;
+
+		// Add an entry to a side table and return its index. Adding a name
+		// that is already in the table returns the existing index.
+		auto add_name(InternedString name) -> std::uint32_t;
+		auto add_literal(std::string_view literal) -> std::uint32_t;
+
+		// Lists are accumulated in a scratch stack while they are parsed,
+		// since the items of an inner list can appear in the middle of an
+		// outer one. Opening a list returns a mark that is used to close
+		// it, which moves its items into the tree. Lists must be closed in
+		// the reverse order in which they were opened.
+		auto open_list() -> std::uint32_t {
+			return static_cast<std::uint32_t>(scratch_.size());
+		}
+
+		void push(NodeId id) {
+			scratch_.push_back(id);
+		}
+
+		auto close_list(std::uint32_t mark) -> ListId;
+
+		// Binary expressions are accumulated in the scratch stack in the
+		// same way, as operands separated by their operators, so that the
+		// grammar needs a single rule for all of them. Closing the
+		// expression builds its nodes by precedence climbing.
+		void push(BinaryOperator op) {
+			scratch_.push_back(static_cast<NodeId>(op));
+		}
+
+		auto close_expression(std::uint32_t mark) -> NodeId;
+
+		// The list without items, which is shared.
+		static constexpr ListId empty_list = 0;
+
+		// Call f with every child of a node, in source order. Children
+		// that are not built yet are skipped.
+		template <typename F>
+		void for_each_child(NodeId id, F &&f) const;
 
 	private:
-		UnaryOperator operator_;
-		std::unique_ptr<Expression> arg_;
-	};
-
-	class BooleanLiteral : public Expression {
-	public:
-		BooleanLiteral(bool value);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		bool value_;
-	};
-
-	class StringLiteral : public Expression {
-	public:
-		StringLiteral(std::string &&value);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::string value_;
-	};
-
-	class NumericLiteral : public Expression {
-	public:
-		NumericLiteral(std::string &&value);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::string value_;
-	};
-
-	class EmptyCompoundLiteral : public Expression {
-	public:
-		EmptyCompoundLiteral(std::unique_ptr<Type> &&type);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Type> type_;
-	};
-
-	class ListLiteral : public Expression {
-	public:
-		ListLiteral(std::unique_ptr<Type> &&type, ExpressionList &&values);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Type> type_;
-		ExpressionList values_;
-	};
-
-	class FieldAssignment : public Node {
-	public:
-		FieldAssignment(); // Required by Bison.
-		FieldAssignment(
-			std::string &&field,
-			std::unique_ptr<Expression> &&value
-		);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::string field_;
-		std::unique_ptr<Expression> value_;
-	};
-
-	using FieldAssignmentList = std::vector<FieldAssignment>;
-
-	class RecordLiteral : public Expression {
-	public:
-		RecordLiteral(
-			std::unique_ptr<Type> &&type,
-			FieldAssignmentList &&assignments
-		);
-
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Type> type_;
-		FieldAssignmentList assignments_;
-	};
-
-	class ArrayAccess : public Expression {
-	public:
-		ArrayAccess(
-			std::unique_ptr<Expression> &&array,
-			std::unique_ptr<Expression> index
-		);
-
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Expression> array_;
-		std::unique_ptr<Expression> index_;
-	};
-
-	class FieldAccess : public Expression {
-	public:
-		FieldAccess(
-			std::unique_ptr<Expression> &&record,
-			std::string &&field
-		);
-
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Expression> record_;
-		std::string field_;
-	};
-
-	class PackageAccess : public Expression {
-	public:
-		PackageAccess(std::string &&package, std::string &&name);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::string package_;
-		std::string name_;
-	};
-
-	class SymbolAccess : public Expression {
-	public:
-		SymbolAccess(std::string &&name);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::string name_;
-	};
-
-	class PointerDereference : public Expression {
-	public:
-		PointerDereference(std::unique_ptr<Expression> &&ptr);
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Expression> ptr_;
-	};
-
-	class TypeCast : public Expression {
-	public:
-		TypeCast(
-			std::unique_ptr<Type> &&type,
-			std::unique_ptr<Expression> &&expr
-		);
-
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::unique_ptr<Type> type_;
-		std::unique_ptr<Expression> expr_;
-	};
-
-	class Import : public Node {
-	public:
-		Import(); // Bison requires an empty constructor.
-		Import(Import &&other);
-		Import& operator=(Import &&other);
-
-		Import(std::string &&path);
-		Import(std::string &&path, std::string &&alias);
-
-		void print(std::ostream &os, int level) const override final;
-
-		~Import();
-
-	private:
-		std::string path_;
-		std::string alias_;
-	};
-
-	class File : public Node {
-	public:
-		File(
-			std::string &&package_name,
-			std::vector<Import> &&imports
-		);
-		~File();
-
-		void print(std::ostream &os, int level) const override final;
-
-	private:
-		std::string name_;
-		std::vector<Import> imports_;
-	};
-
-} // namespace Primordial
+		struct Operands {
+			std::uint32_t lhs;
+			std::uint32_t rhs;
+		};
+
+		std::vector<Kind> kinds_;
+		std::vector<Operands> operands_;
+		std::vector<std::uint8_t> operators_;
+		std::vector<InternedString> names_;
+		std::vector<std::string_view> literals_;
+		std::vector<NodeId> lists_ = {0};
+		NodeId root_ = none;
+
+		// Only needed to build the tree. Name slots map the id of interned
+		// strings to one plus their index in the names table.
+		std::vector<NodeId> scratch_;
+		std::vector<std::uint32_t> name_slots_;
+
+		// Only needed to build the tree as well. Types are keyed by their
+		// kind and canonical operands, lists of types by a hash of their
+		// items, and numeric array sizes by their text.
+		struct TypeKey {
+			Kind kind;
+			std::uint32_t lhs;
+			std::uint32_t rhs;
+
+			bool operator==(TypeKey const &) const = default;
+		};
+
+		struct TypeKeyHash {
+			auto operator()(TypeKey const &key) const -> std::size_t;
+		};
+
+		std::unordered_map<TypeKey, NodeId, TypeKeyHash> types_;
+		std::unordered_multimap<std::uint64_t, ListId> type_lists_;
+		std::unordered_map<std::string_view, NodeId> array_sizes_;
+
+		auto canonical_list(ListId id) -> ListId;
+		auto canonical_size(NodeId id) -> NodeId;
+	};
+
+	template <typename F>
+	void Tree::for_each_child(NodeId id, F &&f) const {
+		auto visit = [&](NodeId child) {
+			if (child != none) {
+				f(child);
+			}
+		};
+
+		auto visit_list = [&](ListId list) {
+			for (auto child : this->list(list)) {
+				visit(child);
+			}
+		};
+
+		auto [l, r] = operands_[id];
+		switch (kinds_[id]) {
+		case Kind::TYPE_NAME:
+		case Kind::QUALIFIED_TYPE_NAME:
+		case Kind::INTERFACE_TYPE:
+		case Kind::BOOLEAN_LITERAL:
+		case Kind::STRING_LITERAL:
+		case Kind::NUMERIC_LITERAL:
+		case Kind::PACKAGE_ACCESS:
+		case Kind::SYMBOL_ACCESS:
+		case Kind::IMPORT:
+			break;
+
+		case Kind::SLICE_TYPE:
+		case Kind::RAW_SLICE_TYPE:
+		case Kind::POINTER_TYPE:
+		case Kind::UNARY_EXPRESSION:
+		case Kind::EMPTY_COMPOUND_LITERAL:
+		case Kind::FIELD_ACCESS:
+		case Kind::POINTER_DEREFERENCE:
+			visit(l);
+			break;
+
+		case Kind::FIELD:
+		case Kind::FIELD_ASSIGNMENT:
+			visit(r);
+			break;
+
+		case Kind::ARRAY_TYPE:
+		case Kind::BINARY_EXPRESSION:
+		case Kind::ARRAY_ACCESS:
+		case Kind::TYPE_CAST:
+			visit(l);
+			visit(r);
+			break;
+
+		case Kind::TYPE_INSTANTIATION:
+		case Kind::LIST_LITERAL:
+		case Kind::RECORD_LITERAL:
+			visit(l);
+			visit_list(r);
+			break;
+
+		case Kind::FUNCTION_TYPE:
+			visit_list(l);
+			visit_list(r);
+			break;
+
+		case Kind::STRUCT_TYPE:
+		case Kind::UNION_TYPE:
+			visit_list(l);
+			break;
+
+		case Kind::FILE:
+			visit_list(r);
+			break;
+		}
+	}
+
+	// Call f with every node of a subtree in pre-order. Shared type nodes
+	// are visited once for every reference.
+	//
+	// The pending nodes are kept in an explicit stack, so the depth of the
+	// tree is only limited by the available memory.
+	template <typename F>
+	void walk(Tree const &tree, NodeId root, F &&f) {
+		std::vector<NodeId> stack{root};
+		std::vector<NodeId> children;
+		while (!stack.empty()) {
+			auto id = stack.back();
+			stack.pop_back();
+			f(id);
+
+			// Push the children in reverse to visit them in source order.
+			children.clear();
+			tree.for_each_child(id, [&](NodeId child) {
+				children.push_back(child);
+			});
+
+			stack.insert(stack.end(), children.rbegin(), children.rend());
+		}
+	}
+
+} // namespace AST
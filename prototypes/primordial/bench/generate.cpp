@@ -0,0 +1,270 @@
+// Generate a synthetic Primordial source file for benchmarking.
+//
+// Usage: generate [--items N] [--imports N] [--depth N] [--fields N]
+//                 [--chain N] [--seed N]
+//
+// The output is a single package with an import group followed by top-level
+// items that cycle through let, var, struct types, union types and
+// functions. Every knob scales a different part of the grammar:
+//
+//   --items    number of top-level items (default 1000)
+//   --imports  number of imports in the import group (default 16)
+//   --depth    nesting depth of the expressions in let and var items
+//              (default 8)
+//   --fields   number of fields of struct and union types (default 8)
+//   --chain    if not 0, replace the expressions in let and var items with
+//              left-associative chains of additions of this many operands
+//              (default 0)
+//   --seed     seed for the pseudo-random choices (default 1)
+//
+// The same arguments always generate the same file.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+	struct Options {
+		long items = 1000;
+		long imports = 16;
+		long depth = 8;
+		long fields = 8;
+		long chain = 0;
+		std::uint32_t seed = 1;
+	};
+
+	class Generator {
+	public:
+		Generator(Options const &options, std::ostream &os)
+		: options_(options), os_(os), rng_(options.seed) {}
+
+		void generate() {
+			os_ << "package Bench\n\nimport (\n";
+			for (long i = 0; i < options_.imports; ++i) {
+				if (i % 4 == 3) {
+					os_ << "\tP" << i << " ";
+				} else {
+					os_ << "\t";
+				}
+
+				os_ << "\"lib/pkg" << i << "\"\n";
+			}
+
+			os_ << ")\n";
+
+			for (long i = 0; i < options_.items; ++i) {
+				os_ << "\n";
+				switch (i % 5) {
+				case 0:
+					os_ << "let a" << i << " = ";
+					item_expression();
+					os_ << "\n";
+					break;
+
+				case 1:
+					os_ << "var b" << i << " Int = ";
+					item_expression();
+					os_ << "\n";
+					break;
+
+				case 2:
+					record("struct", i);
+					break;
+
+				case 3:
+					record("union", i);
+					break;
+
+				case 4:
+					function(i);
+					break;
+				}
+			}
+		}
+
+	private:
+		auto pick(std::uint32_t n) -> std::uint32_t {
+			// Use the raw engine output because the distributions are not
+			// guaranteed to produce the same values everywhere.
+			return rng_() % n;
+		}
+
+		// Number of package names used in qualified names.
+		auto packages() const -> long {
+			return options_.imports > 0 ? options_.imports : 1;
+		}
+
+		void item_expression() {
+			if (options_.chain > 0) {
+				chain(options_.chain);
+			} else {
+				expression(options_.depth);
+			}
+		}
+
+		// Emit a + b + c + ..., which the parser turns into a tree whose
+		// depth is the number of operands.
+		void chain(long operands) {
+			os_ << "x" << pick(1000);
+			for (long i = 1; i < operands; ++i) {
+				os_ << " + x" << pick(1000);
+			}
+		}
+
+		// Emit a right-leaning chain of depth binary operators, where some
+		// of the right operands are parenthesised. The size of the output
+		// is linear in the depth, and it is generated iteratively so that
+		// any depth can be used.
+		void expression(long depth) {
+			static char const *const operators[] = {
+				" + ", " - ", " * ", " / ", " % ", " & ", " | ", " ^ ",
+				" << ", " >> ", " == ", " != ", " < ", " <= ", " > ",
+				" >= ", " && ", " || ",
+			};
+
+			long open = 0;
+			term();
+			for (long i = 0; i < depth; ++i) {
+				os_ << operators[pick(std::size(operators))];
+				if (pick(2) == 0) {
+					os_ << "(";
+					++open;
+				}
+
+				term();
+			}
+
+			for (long i = 0; i < open; ++i) {
+				os_ << ")";
+			}
+		}
+
+		void term() {
+			auto n = pick(1000);
+			switch (pick(9)) {
+			case 0:
+				os_ << "x" << n;
+				break;
+			case 1:
+				os_ << n;
+				break;
+			case 2:
+				os_ << "0x" << std::hex << n << std::dec;
+				break;
+			case 3:
+				os_ << "\"s" << n << "\"";
+				break;
+			case 4:
+				os_ << "p" << n << ".field";
+				break;
+			case 5:
+				os_ << "P" << n % packages() << ".sym" << n;
+				break;
+			case 6:
+				os_ << "f" << n << "(x, " << n << ")";
+				break;
+			case 7:
+				os_ << "a" << n << "[i]";
+				break;
+			case 8:
+				os_ << "-y" << n;
+				break;
+			}
+		}
+
+		void type() {
+			switch (pick(5)) {
+			case 0:
+				os_ << "Int";
+				break;
+			case 1:
+				os_ << "P" << pick(1000) % packages() << ".Type";
+				break;
+			case 2:
+				os_ << "List[Int]";
+				break;
+			case 3:
+				os_ << "Int[]";
+				break;
+			case 4:
+				os_ << "Byte[16]";
+				break;
+			}
+		}
+
+		void record(char const *kind, long i) {
+			os_ << "type T" << i << " " << kind << " {\n";
+			for (long f = 0; f < options_.fields; ++f) {
+				os_ << "\tf" << f << " ";
+				type();
+				os_ << "\n";
+			}
+
+			os_ << "}\n";
+		}
+
+		void function(long i) {
+			os_ << "func fn" << i << "(x Int, y Int) -> (Int) {\n";
+			os_ << "\tz := ";
+			expression(options_.depth / 2);
+			os_ << "\n\tif z < " << i << " {\n";
+			os_ << "\t\tg(z, \"branch\", 0x" << std::hex << i << std::dec;
+			os_ << ")\n\t} else {\n";
+			os_ << "\t\tz = z + 1\n\t}\n";
+			os_ << "\twhile x < y {\n\t\tx = x + 1\n\t}\n";
+			os_ << "\tr := T" << i - 2 << "{f0: x, f1: y}\n";
+			os_ << "\tl := Int[]{1, 2, x, y * z}\n";
+			os_ << "}\n";
+		}
+
+		Options const &options_;
+		std::ostream &os_;
+		std::mt19937 rng_;
+	};
+
+	[[noreturn]] void usage() {
+		std::cerr << "usage: generate [--items N] [--imports N] "
+			"[--depth N] [--fields N] [--chain N] [--seed N]\n";
+		std::exit(2);
+	}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		if (i + 1 >= argc) {
+			usage();
+		}
+
+		long value = std::atol(argv[i + 1]);
+		if (value < 0) {
+			usage();
+		}
+
+		if (std::strcmp(argv[i], "--items") == 0) {
+			options.items = value;
+		} else if (std::strcmp(argv[i], "--imports") == 0) {
+			options.imports = value;
+		} else if (std::strcmp(argv[i], "--depth") == 0) {
+			options.depth = value;
+		} else if (std::strcmp(argv[i], "--fields") == 0) {
+			options.fields = value;
+		} else if (std::strcmp(argv[i], "--chain") == 0) {
+			options.chain = value;
+		} else if (std::strcmp(argv[i], "--seed") == 0) {
+			options.seed = static_cast<std::uint32_t>(value);
+		} else {
+			usage();
+		}
+
+		++i;
+	}
+
+	std::ios::sync_with_stdio(false);
+	Generator(options, std::cout).generate();
+}
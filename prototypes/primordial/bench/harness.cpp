@@ -0,0 +1,305 @@
+// Measure the throughput of the prototype parser.
+//
+// Usage: harness [--repeat N] file...
+//
+// Every file goes through these phases, each of which is repeated N times
+// (default 5), keeping the fastest run:
+//
+//   lex    map the file and run the lexer until the end of the input
+//   parse  map, lex and parse the file (so it includes the lex phase)
+//   lazy   like parse, but skipping the bodies of top-level functions
+//   walk   visit every node of the AST in pre-order
+//   print  emit every node of the AST to a stream that discards the output
+//   free   destroy the AST
+//
+// The walk and print phases start from every node without a parent, so
+// they cover the items that are not attached to the file yet too. Type
+// nodes are shared, and they are visited once for every reference.
+//
+// For every phase, it reports the throughput in bytes, tokens and AST nodes
+// per second, the number and size of heap allocations, and the peak RSS.
+// Nodes are the nodes of the syntax tree, including list elements such as
+// imports and fields.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "allocations.hpp"
+#include "emit.hpp"
+#include "primordial.hpp"
+#include "parser.hpp"
+#include "scanner.hpp"
+
+yy::Parser::symbol_type yylex(void *yyscanner, Primordial::Location &loc);
+
+namespace {
+
+	struct Phase {
+		char const *name;
+		double seconds = std::numeric_limits<double>::infinity();
+		std::size_t allocations = 0;
+		std::size_t allocated_bytes = 0;
+		long peak_rss_kib = 0;
+	};
+
+	// Reset the peak RSS of the process so that it can be measured per
+	// phase. Supported since Linux 4.0; otherwise, the peak is cumulative.
+	void reset_peak_rss() {
+		std::ofstream("/proc/self/clear_refs") << "5";
+	}
+
+	auto peak_rss_kib() -> long {
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while (std::getline(status, line)) {
+			if (line.rfind("VmHWM:", 0) == 0) {
+				return std::atol(line.c_str() + 6);
+			}
+		}
+
+		return 0;
+	}
+
+	// Run f once and update the statistics of the phase.
+	template <typename F>
+	void measure(Phase &phase, F &&f) {
+		reset_peak_rss();
+		auto before = Primordial::thread_allocations();
+		auto start = std::chrono::steady_clock::now();
+
+		f();
+
+		auto end = std::chrono::steady_clock::now();
+		std::chrono::duration<double> elapsed = end - start;
+		phase.seconds = std::min(phase.seconds, elapsed.count());
+		auto after = Primordial::thread_allocations();
+		phase.allocations = after.count - before.count;
+		phase.allocated_bytes = after.bytes - before.bytes;
+		phase.peak_rss_kib = std::max(phase.peak_rss_kib, peak_rss_kib());
+	}
+
+	class NullBuffer : public std::streambuf {
+	protected:
+		auto overflow(int c) -> int override {
+			return c;
+		}
+
+		auto xsputn(char const *, std::streamsize n)
+			-> std::streamsize override {
+			return n;
+		}
+	};
+
+	auto lex(Primordial::Driver &drv, std::string const &path)
+		-> std::size_t {
+		auto source = Primordial::Source::map(path);
+		drv.can_insert_semicolon = false;
+
+		yyscan_t scanner;
+		yylex_init_extra(&drv, &scanner);
+		auto buffer = yy_scan_buffer(
+			source->scan_buffer(),
+			source->scan_buffer_size(),
+			scanner
+		);
+
+		auto const end = yy::Parser::symbol_kind::S_YYEOF;
+		Primordial::Location loc;
+		std::size_t tokens = 0;
+		try {
+			while (yylex(scanner, loc).kind() != end) {
+				++tokens;
+			}
+		} catch (Primordial::LexicalError const &) {
+			std::cerr << path << ": lexical error\n";
+		}
+
+		yy_delete_buffer(buffer, scanner);
+		yylex_destroy(scanner);
+		return tokens;
+	}
+
+	void report(
+		Phase const &phase,
+		std::size_t bytes,
+		std::size_t tokens,
+		std::size_t nodes
+	) {
+		auto rate = [&](std::size_t n, double unit) {
+			std::cout << std::setw(12);
+			if (n == 0) {
+				std::cout << "-";
+			} else {
+				std::cout << n / phase.seconds / unit;
+			}
+		};
+
+		std::cout << std::left << std::setw(8) << phase.name << std::right;
+		std::cout << std::setw(12) << phase.seconds * 1e3;
+		rate(bytes, 1e6);
+		rate(tokens, 1e6);
+		rate(nodes, 1e6);
+		std::cout << std::setw(12) << phase.allocations;
+		std::cout << std::setw(12) << phase.allocated_bytes / 1e6;
+		std::cout << std::setw(12) << phase.peak_rss_kib / 1024.0;
+		std::cout << "\n";
+	}
+
+	// Nodes that are not the child of any other node.
+	auto roots(AST::Tree const &tree) -> std::vector<AST::NodeId> {
+		std::vector<bool> is_child(tree.size());
+		for (AST::NodeId id = 0; id < tree.size(); ++id) {
+			tree.for_each_child(id, [&](AST::NodeId child) {
+				is_child[child] = true;
+			});
+		}
+
+		std::vector<AST::NodeId> roots;
+		for (AST::NodeId id = 0; id < tree.size(); ++id) {
+			if (!is_child[id]) {
+				roots.push_back(id);
+			}
+		}
+
+		return roots;
+	}
+
+	auto benchmark(std::string const &path, int repeat) -> bool {
+		Phase lex_phase{"lex"};
+		Phase parse_phase{"parse"};
+		Phase lazy_phase{"lazy"};
+		Phase walk_phase{"walk"};
+		Phase print_phase{"print"};
+		Phase free_phase{"free"};
+		std::size_t bytes = 0;
+		std::size_t tokens = 0;
+		std::size_t nodes = 0;
+		std::size_t lazy_nodes = 0;
+
+		for (int i = 0; i < repeat; ++i) {
+			Primordial::Driver drv;
+			measure(lex_phase, [&] {
+				tokens = lex(drv, path);
+			});
+		}
+
+		for (int i = 0; i < repeat; ++i) {
+			Primordial::Driver drv;
+			NullBuffer null_buffer;
+			std::ostream null_stream(&null_buffer);
+
+			int status;
+			measure(parse_phase, [&] {
+				status = drv.parse_file(path);
+			});
+
+			if (status != 0) {
+				std::cerr << path << ": parse failed\n";
+				return false;
+			}
+
+			auto result = drv.result();
+			auto const &tree = *result;
+			auto const tree_roots = roots(tree);
+			nodes = tree.size();
+
+			std::size_t visited = 0;
+			measure(walk_phase, [&] {
+				for (auto root : tree_roots) {
+					AST::walk(tree, root, [&](AST::NodeId) {
+						++visited;
+					});
+				}
+			});
+
+			if (visited < nodes) {
+				std::cerr << path << ": walk missed nodes\n";
+				return false;
+			}
+
+			measure(print_phase, [&] {
+				AST::Emitter emitter(null_stream);
+				for (auto root : tree_roots) {
+					emitter.emit(tree, root);
+				}
+			});
+
+			measure(free_phase, [&] {
+				result = {};
+			});
+		}
+
+		for (int i = 0; i < repeat; ++i) {
+			Primordial::Driver drv;
+			drv.set_lazy_bodies(true);
+
+			int status;
+			measure(lazy_phase, [&] {
+				status = drv.parse_file(path);
+			});
+
+			if (status != 0) {
+				std::cerr << path << ": lazy parse failed\n";
+				return false;
+			}
+
+			lazy_nodes = drv.result()->size();
+		}
+
+		bytes = Primordial::Source::map(path)->text().size();
+
+		std::cout << path << ": " << bytes << " bytes, " << tokens
+			<< " tokens, " << nodes << " nodes\n";
+		std::cout << std::left << std::setw(8) << "phase" << std::right
+			<< std::setw(12) << "ms"
+			<< std::setw(12) << "MB/s"
+			<< std::setw(12) << "Mtokens/s"
+			<< std::setw(12) << "Mnodes/s"
+			<< std::setw(12) << "allocs"
+			<< std::setw(12) << "alloc MB"
+			<< std::setw(12) << "peak MiB"
+			<< "\n";
+		std::cout << std::fixed << std::setprecision(2);
+		report(lex_phase, bytes, tokens, 0);
+		report(parse_phase, bytes, tokens, nodes);
+		report(lazy_phase, bytes, 0, lazy_nodes);
+		report(walk_phase, 0, 0, nodes);
+		report(print_phase, 0, 0, nodes);
+		report(free_phase, 0, 0, nodes);
+		std::cout << std::defaultfloat << "\n";
+		return true;
+	}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	int repeat = 5;
+	std::vector<std::string> paths;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+			repeat = std::max(std::atoi(argv[++i]), 1);
+		} else {
+			paths.push_back(argv[i]);
+		}
+	}
+
+	if (paths.empty()) {
+		std::cerr << "usage: harness [--repeat N] file...\n";
+		return 2;
+	}
+
+	bool ok = true;
+	for (auto const &path : paths) {
+		ok = benchmark(path, repeat) && ok;
+	}
+
+	return ok ? 0 : 1;
+}
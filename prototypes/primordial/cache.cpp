@@ -0,0 +1,238 @@
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include "cache.hpp"
+
+// Set by the build to a hash of the grammar and the AST definitions.
+#ifndef PRIMORDIAL_PARSER_VERSION
+#define PRIMORDIAL_PARSER_VERSION "unversioned"
+#endif
+
+namespace Primordial {
+
+	// Layout of an entry, in host byte order:
+	//
+	//   Header
+	//   ImportRecord[import_count]
+	//   string table
+	//
+	// Strings are stored as an offset and a size into the string table.
+	// Increase the format version whenever the layout changes.
+	static constexpr std::uint32_t format_version = 1;
+	static constexpr char magic[8] = {'P', 'R', 'I', 'M', 'A', 'S', 'T', '\n'};
+
+	struct StringRef {
+		std::uint32_t offset;
+		std::uint32_t size;
+	};
+
+	struct Header {
+		char magic[8];
+		std::uint32_t format_version;
+		std::uint32_t import_count;
+		StringRef name;
+	};
+
+	struct ImportRecord {
+		StringRef path;
+		StringRef alias;
+	};
+
+	// Non-cryptographic 64-bit hash that consumes eight bytes per step,
+	// followed by the MurmurHash3 finaliser.
+	static auto hash(std::string_view s, std::uint64_t seed)
+		-> std::uint64_t {
+		constexpr std::uint64_t k = 0x9e3779b97f4a7c15;
+		std::uint64_t h = seed ^ (s.size() * k);
+
+		std::size_t i = 0;
+		for (; i + 8 <= s.size(); i += 8) {
+			std::uint64_t w;
+			std::memcpy(&w, s.data() + i, 8);
+			h = std::rotl(h ^ w, 31) * k;
+		}
+
+		if (i < s.size()) {
+			std::uint64_t w = 0;
+			std::memcpy(&w, s.data() + i, s.size() - i);
+			h = std::rotl(h ^ w, 31) * k;
+		}
+
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccd;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53;
+		h ^= h >> 33;
+		return h;
+	}
+
+	Cache::Cache(std::string dir) : dir_(std::move(dir)) {
+		std::error_code ec;
+		std::filesystem::create_directories(dir_, ec);
+	}
+
+	auto Cache::key(std::string_view text) const -> std::string {
+		static std::uint64_t const version_hash =
+			hash(PRIMORDIAL_PARSER_VERSION, format_version);
+
+		// Including the size makes collisions even less likely.
+		char key[40];
+		std::snprintf(
+			key,
+			sizeof key,
+			"%016llx-%llx",
+			static_cast<unsigned long long>(hash(text, version_hash)),
+			static_cast<unsigned long long>(text.size())
+		);
+
+		return key;
+	}
+
+	auto Cache::path(std::string const &key) const -> std::string {
+		return dir_ + "/" + key + ".ast";
+	}
+
+	auto Cache::load(
+		std::string const &key,
+		Interner &interner
+	) const -> Entry {
+		Entry entry;
+		try {
+			entry.mapping = Source::map(path(key));
+		} catch (std::system_error const &) {
+			return {};
+		}
+
+		auto data = entry.mapping->text();
+		Header header;
+		if (data.size() < sizeof header) {
+			return {};
+		}
+
+		std::memcpy(&header, data.data(), sizeof header);
+		if (std::memcmp(header.magic, magic, sizeof magic) != 0
+			|| header.format_version != format_version) {
+			return {};
+		}
+
+		auto records = data.substr(sizeof header);
+		if (header.import_count > records.size() / sizeof(ImportRecord)) {
+			return {};
+		}
+
+		auto strings = records.substr(
+			header.import_count * sizeof(ImportRecord)
+		);
+
+		bool valid = true;
+		auto string = [&](StringRef ref) -> std::string_view {
+			if (ref.offset > strings.size()
+				|| ref.size > strings.size() - ref.offset) {
+				valid = false;
+				return {};
+			}
+
+			return strings.substr(ref.offset, ref.size);
+		};
+
+		auto &tree = entry.tree;
+		auto imports = tree.open_list();
+		for (std::uint32_t i = 0; i < header.import_count; ++i) {
+			ImportRecord record;
+			std::memcpy(
+				&record,
+				records.data() + i * sizeof record,
+				sizeof record
+			);
+
+			auto path = tree.add_literal(string(record.path));
+			auto alias = string(record.alias);
+			auto alias_index = alias.empty()
+				? AST::none
+				: tree.add_name(interner.intern(alias));
+
+			tree.push(tree.add(AST::Kind::IMPORT, path, alias_index));
+		}
+
+		auto name = string(header.name);
+		if (!valid) {
+			return {};
+		}
+
+		tree.complete(tree.add(
+			AST::Kind::FILE,
+			tree.add_name(interner.intern(name)),
+			tree.close_list(imports)
+		));
+
+		return entry;
+	}
+
+	void Cache::store(std::string const &key, AST::Tree const &tree) const {
+		std::string strings;
+		auto add = [&](std::string_view s) {
+			StringRef ref{
+				static_cast<std::uint32_t>(strings.size()),
+				static_cast<std::uint32_t>(s.size()),
+			};
+
+			strings.append(s);
+			return ref;
+		};
+
+		Header header{};
+		std::memcpy(header.magic, magic, sizeof magic);
+		header.format_version = format_version;
+		auto file = tree.root();
+		auto imports = tree.list(tree.rhs(file));
+		header.import_count = static_cast<std::uint32_t>(imports.size());
+		header.name = add(tree.name(tree.lhs(file)).view());
+
+		std::string data;
+		data.append(reinterpret_cast<char const *>(&header), sizeof header);
+		for (auto import : imports) {
+			auto alias = tree.rhs(import);
+			ImportRecord record{
+				add(tree.literal(tree.lhs(import))),
+				add(alias == AST::none ? "" : tree.name(alias).view()),
+			};
+
+			data.append(
+				reinterpret_cast<char const *>(&record),
+				sizeof record
+			);
+		}
+
+		data.append(strings);
+
+		// Make the name of the temporary file unique among the threads of
+		// every process sharing the cache.
+		auto final_path = path(key);
+		auto thread = std::hash<std::thread::id>{}(std::this_thread::get_id());
+		auto tmp_path = final_path + ".tmp." + std::to_string(::getpid())
+			+ "." + std::to_string(thread);
+
+		std::error_code ec;
+		{
+			std::ofstream out(tmp_path, std::ios::binary);
+			out.write(data.data(), static_cast<std::streamsize>(data.size()));
+			out.close();
+			if (!out) {
+				std::filesystem::remove(tmp_path, ec);
+				return;
+			}
+		}
+
+		std::filesystem::rename(tmp_path, final_path, ec);
+		if (ec) {
+			std::filesystem::remove(tmp_path, ec);
+		}
+	}
+
+} // namespace Primordial
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "ast.hpp"
+#include "intern.hpp"
+#include "source.hpp"
+
+namespace Primordial {
+
+	// On-disk cache of parse results.
+	//
+	// Entries are keyed by a hash of the source text and of the parser
+	// version, so editing the grammar or the AST invalidates every entry.
+	// An entry is a compact binary image of the file node of a tree.
+	// Loading it maps the entry into memory: names are interned, and the
+	// remaining strings point straight into the mapping.
+	//
+	// Entries are written to a temporary file and renamed into place, so
+	// concurrent writers never expose partial entries. A Cache has no
+	// mutable state and can be shared by drivers on different threads.
+	class Cache {
+	public:
+		// The directory is created if it does not exist.
+		explicit Cache(std::string dir);
+
+		struct Entry {
+			// Keeps the strings of the tree alive.
+			std::unique_ptr<Source> mapping;
+			AST::Tree tree;
+		};
+
+		auto key(std::string_view text) const -> std::string;
+
+		// Load an entry. Returns an entry without a mapping on a miss or
+		// if the entry is invalid.
+		auto load(std::string const &key, Interner &interner) const
+			-> Entry;
+
+		// Store the file of a complete tree. Errors are ignored, since the
+		// cache is only an optimisation.
+		void store(std::string const &key, AST::Tree const &tree) const;
+
+	private:
+		auto path(std::string const &key) const -> std::string;
+
+		std::string dir_;
+	};
+
+} // namespace Primordial
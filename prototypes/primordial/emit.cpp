@@ -0,0 +1,395 @@
+#include <stdexcept>
+#include "emit.hpp"
+
+namespace AST {
+
+	// Large enough to turn the output of big trees into a few writes.
+	static constexpr std::size_t flush_threshold = 64 * 1024;
+
+	static auto binary_operator_string(BinaryOperator op) -> std::string_view {
+		switch (op) {
+			case BinaryOperator::LOGICAL_OR: return "||";
+			case BinaryOperator::LOGICAL_AND: return "&&";
+			case BinaryOperator::EQ: return "==";
+			case BinaryOperator::NE: return "!=";
+			case BinaryOperator::LE: return "<=";
+			case BinaryOperator::GE: return ">=";
+			case BinaryOperator::LT: return "<";
+			case BinaryOperator::GT: return ">";
+			case BinaryOperator::ADD: return "+";
+			case BinaryOperator::SUB: return "-";
+			case BinaryOperator::BITWISE_OR: return "|";
+			case BinaryOperator::BITWISE_XOR: return "^";
+			case BinaryOperator::MUL: return "*";
+			case BinaryOperator::DIV: return "/";
+			case BinaryOperator::REM: return "%";
+			case BinaryOperator::BITWISE_AND: return "&";
+			case BinaryOperator::BITWISE_CLEAR: return "&^";
+			case BinaryOperator::LEFT_SHIFT: return "<<";
+			case BinaryOperator::RIGHT_SHIFT: return ">>";
+		}
+
+		throw std::invalid_argument("unknown binary operator");
+	}
+
+	static auto unary_operator_string(UnaryOperator op) -> std::string_view {
+		switch (op) {
+			case UnaryOperator::NEG: return "-";
+			case UnaryOperator::BITWISE_NOT: return "~";
+			case UnaryOperator::LOGICAL_NOT: return "!";
+			case UnaryOperator::ADDRESS_OF: return "@";
+		}
+
+		throw std::invalid_argument("unknown unary operator");
+	}
+
+	Emitter::Emitter(std::ostream &os) : os_(os) {
+		buffer_.reserve(flush_threshold);
+	}
+
+	Emitter::~Emitter() {
+		flush();
+	}
+
+	void Emitter::emit(Tree const &tree) {
+		emit(tree, tree.root());
+	}
+
+	void Emitter::emit(Tree const &tree, NodeId id) {
+		tree_ = &tree;
+		run(id, 0);
+		tree_ = nullptr;
+	}
+
+	void Emitter::flush() {
+		if (!buffer_.empty()) {
+			os_.write(buffer_.data(), buffer_.size());
+			buffer_.clear();
+		}
+	}
+
+	void Emitter::maybe_flush() {
+		if (buffer_.size() >= flush_threshold) {
+			flush();
+		}
+	}
+
+	void Emitter::indent(int level) {
+		if (level > 0) {
+			buffer_.append(level, '\t');
+		}
+	}
+
+	void Emitter::run(NodeId id, int level) {
+		tasks_.push_back({id, 0, level});
+		while (!tasks_.empty()) {
+			auto task = tasks_.back();
+			tasks_.pop_back();
+
+			// Nodes that the grammar does not build yet are skipped.
+			if (task.id != none) {
+				resume(task);
+				maybe_flush();
+			}
+		}
+	}
+
+	void Emitter::descend(Task const &task, NodeId child, int level) {
+		tasks_.push_back({task.id, task.step + 1, task.level});
+		tasks_.push_back({child, 0, level});
+	}
+
+	bool Emitter::list_item(
+		Task const &task,
+		ListId list,
+		std::uint32_t first,
+		int level,
+		std::string_view separator
+	) {
+		auto items = tree_->list(list);
+		auto i = task.step - first;
+		if (i >= items.size()) {
+			return false;
+		}
+
+		if (i > 0) {
+			write(separator);
+		}
+
+		descend(task, items[i], level);
+		return true;
+	}
+
+	void Emitter::resume(Task const &task) {
+		auto const &tree = *tree_;
+		auto const id = task.id;
+		auto const step = task.step;
+		auto const level = task.level;
+		auto const lhs = tree.lhs(id);
+		auto const rhs = tree.rhs(id);
+		switch (tree.kind(id)) {
+		case Kind::TYPE_NAME:
+			write(tree.name(lhs).view());
+			break;
+
+		case Kind::QUALIFIED_TYPE_NAME:
+			write(tree.name(lhs).view());
+			write('.');
+			write(tree.name(rhs).view());
+			break;
+
+		case Kind::TYPE_INSTANTIATION:
+			if (step == 0) {
+				descend(task, lhs, level);
+				break;
+			}
+
+			if (step == 1) {
+				write('[');
+			}
+
+			if (!list_item(task, rhs, 1, level)) {
+				write(']');
+			}
+
+			break;
+
+		case Kind::ARRAY_TYPE:
+		case Kind::ARRAY_ACCESS:
+			if (step == 0) {
+				descend(task, lhs, level);
+			} else if (step == 1) {
+				write('[');
+				descend(task, rhs, level);
+			} else {
+				write(']');
+			}
+
+			break;
+
+		case Kind::SLICE_TYPE:
+			if (step == 0) {
+				descend(task, lhs, level);
+			} else {
+				write("[]");
+			}
+
+			break;
+
+		case Kind::RAW_SLICE_TYPE:
+			if (step == 0) {
+				descend(task, lhs, level);
+			} else {
+				write("[_]");
+			}
+
+			break;
+
+		case Kind::POINTER_TYPE:
+			if (step == 0) {
+				descend(task, lhs, level);
+			} else {
+				write('?');
+			}
+
+			break;
+
+		case Kind::FUNCTION_TYPE: {
+			auto const inputs = tree.list(lhs).size();
+			if (step == 0) {
+				write("func (");
+			}
+
+			if (list_item(task, lhs, 0, level)) {
+				break;
+			}
+
+			if (step == inputs) {
+				write(") -> (");
+			}
+
+			if (!list_item(task, rhs, inputs, level)) {
+				write(')');
+			}
+
+			break;
+		}
+
+		case Kind::FIELD:
+			indent(level);
+			if (lhs != none) {
+				write(tree.name(lhs).view());
+				write(' ');
+			}
+
+			tasks_.push_back({rhs, 0, level});
+			break;
+
+		case Kind::STRUCT_TYPE:
+		case Kind::UNION_TYPE:
+			if (step == 0) {
+				if (tree.kind(id) == Kind::STRUCT_TYPE) {
+					write("struct {\n");
+				} else {
+					write("union {\n");
+				}
+			}
+
+			if (!list_item(task, lhs, 0, level + 1, "")) {
+				write("}\n");
+			}
+
+			break;
+
+		case Kind::INTERFACE_TYPE:
+			// TODO
+			break;
+
+		case Kind::BINARY_EXPRESSION:
+			if (step == 0) {
+				write('(');
+				descend(task, lhs, level);
+			} else if (step == 1) {
+				write(") ");
+				write(binary_operator_string(tree.binary_operator(id)));
+				write(" (");
+				descend(task, rhs, level);
+			} else {
+				write(')');
+			}
+
+			break;
+
+		case Kind::UNARY_EXPRESSION:
+			write(unary_operator_string(tree.unary_operator(id)));
+			write(' ');
+			tasks_.push_back({lhs, 0, level});
+			break;
+
+		case Kind::BOOLEAN_LITERAL:
+			write(lhs ? "true" : "false");
+			break;
+
+		case Kind::STRING_LITERAL:
+		case Kind::NUMERIC_LITERAL:
+			write(tree.literal(lhs));
+			break;
+
+		case Kind::EMPTY_COMPOUND_LITERAL:
+			if (step == 0) {
+				descend(task, lhs, level);
+			} else {
+				write(" {}");
+			}
+
+			break;
+
+		case Kind::LIST_LITERAL:
+			if (step == 0) {
+				descend(task, lhs, level);
+				break;
+			}
+
+			if (step == 1) {
+				write(" {");
+			} else {
+				write('\n');
+			}
+
+			if (step - 1 < tree.list(rhs).size()) {
+				indent(level + 1);
+			}
+
+			if (!list_item(task, rhs, 1, level + 1, "")) {
+				write("};");
+			}
+
+			break;
+
+		case Kind::FIELD_ASSIGNMENT:
+			write(tree.name(lhs).view());
+			write(": ");
+			tasks_.push_back({rhs, 0, level});
+			break;
+
+		case Kind::RECORD_LITERAL:
+			write(step == 0 ? "{\n" : ",\n");
+			if (!list_item(task, rhs, 0, level + 1, "")) {
+				indent(level);
+				write('}');
+			}
+
+			break;
+
+		case Kind::FIELD_ACCESS:
+			if (step == 0) {
+				descend(task, lhs, level);
+			} else {
+				write('.');
+				write(tree.name(rhs).view());
+			}
+
+			break;
+
+		case Kind::PACKAGE_ACCESS:
+			write(tree.name(lhs).view());
+			write('.');
+			write(tree.name(rhs).view());
+			break;
+
+		case Kind::SYMBOL_ACCESS:
+			write(tree.name(lhs).view());
+			break;
+
+		case Kind::POINTER_DEREFERENCE:
+			if (step == 0) {
+				descend(task, lhs, level);
+			} else {
+				write('.');
+			}
+
+			break;
+
+		case Kind::TYPE_CAST:
+			if (step == 0) {
+				descend(task, lhs, level);
+			} else if (step == 1) {
+				write('(');
+				descend(task, rhs, level);
+			} else {
+				write(')');
+			}
+
+			break;
+
+		case Kind::IMPORT:
+			indent(level);
+			write("import ");
+			if (rhs != none) {
+				write(tree.name(rhs).view());
+				write(' ');
+			}
+
+			write(tree.literal(lhs));
+			write('\n');
+			break;
+
+		case Kind::FILE:
+			if (step == 0) {
+				indent(level);
+				write("package ");
+				write(tree.name(lhs).view());
+				write("\n\n");
+			}
+
+			if (!list_item(task, rhs, 0, level, "")) {
+				if (step > 0) {
+					write('\n');
+				}
+			}
+
+			break;
+		}
+	}
+
+} // namespace AST
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ast.hpp"
+
+namespace AST {
+
+	// Writes the textual form of an AST.
+	//
+	// The text is accumulated in a buffer that is reused between calls, and
+	// written to the stream in large blocks: whenever the buffer grows past
+	// a threshold, when flush() is called, and on destruction.
+	//
+	// Nodes are emitted with an explicit stack of pending tasks instead of
+	// recursion, so arbitrarily deep trees, such as long chains of binary
+	// operators, can be emitted without exhausting the call stack. There
+	// is at most one pending task per level of the tree.
+	class Emitter {
+	public:
+		explicit Emitter(std::ostream &os);
+		~Emitter();
+
+		Emitter(Emitter const &) = delete;
+		Emitter& operator=(Emitter const &) = delete;
+
+		// Emit the file at the root of a complete tree.
+		void emit(Tree const &tree);
+
+		// Emit any node of a tree.
+		void emit(Tree const &tree, NodeId id);
+
+		void flush();
+
+	private:
+		// A node that is being emitted, and the part of it that comes
+		// next. Every node is emitted in steps, separated by its children.
+		struct Task {
+			NodeId id;
+			std::uint32_t step;
+			int level;
+		};
+
+		void run(NodeId id, int level);
+		void resume(Task const &task);
+
+		// Emit a child, then resume the task at the next step.
+		void descend(Task const &task, NodeId child, int level);
+
+		// Emit the item of a list that corresponds to the step of a task,
+		// where the first item is emitted at the given step. Returns false
+		// once every item has been emitted.
+		bool list_item(
+			Task const &task,
+			ListId list,
+			std::uint32_t first,
+			int level,
+			std::string_view separator = ", "
+		);
+
+		void indent(int level);
+
+		void write(std::string_view s) {
+			buffer_.append(s);
+		}
+
+		void write(char c) {
+			buffer_.push_back(c);
+		}
+
+		void maybe_flush();
+
+		std::ostream &os_;
+		std::string buffer_;
+		std::vector<Task> tasks_;
+		Tree const *tree_ = nullptr;
+	};
+
+} // namespace AST
@@ -0,0 +1,34 @@
+#include "intern.hpp"
+
+namespace Primordial {
+
+	auto operator<<(std::ostream &os, InternedString s) -> std::ostream & {
+		return os << s.view();
+	}
+
+	auto Interner::intern(std::string_view s) -> InternedString {
+		auto it = strings_.find(s);
+		if (it == strings_.end()) {
+			auto id = static_cast<std::uint32_t>(strings_.size());
+			it = strings_.emplace(arena_.copy(s), id).first;
+		}
+
+		return InternedString(it->first, it->second);
+	}
+
+	auto Interner::size() const -> std::size_t {
+		return strings_.size();
+	}
+
+	bool Interner::Shortlex::operator()(
+		std::string_view a,
+		std::string_view b
+	) const {
+		if (a.size() != b.size()) {
+			return a.size() < b.size();
+		}
+
+		return a < b;
+	}
+
+} // namespace Primordial
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string_view>
+#include "arena.hpp"
+
+namespace Primordial {
+
+	// A string owned by an Interner.
+	//
+	// Equal strings interned by the same Interner share the same storage,
+	// so comparing two interned strings only needs to compare pointers.
+	// Like strintern, the handle carries the whole slice so that it can be
+	// printed or inspected without going back to the interner. It also
+	// carries a dense index, which fits in what would otherwise be padding.
+	class InternedString {
+	public:
+		InternedString() = default;
+
+		auto view() const -> std::string_view {
+			return std::string_view(data_, size_);
+		}
+
+		// The strings of an interner are numbered from 0 in the order in
+		// which they were first interned.
+		auto id() const -> std::uint32_t {
+			return id_;
+		}
+
+		bool empty() const {
+			return size_ == 0;
+		}
+
+		friend bool operator==(InternedString a, InternedString b) {
+			return a.data_ == b.data_;
+		}
+
+	private:
+		friend class Interner;
+
+		InternedString(std::string_view s, std::uint32_t id)
+		: data_(s.data())
+		, size_(static_cast<std::uint32_t>(s.size()))
+		, id_(id) {}
+
+		char const *data_ = nullptr;
+		std::uint32_t size_ = 0;
+		std::uint32_t id_ = 0;
+	};
+
+	auto operator<<(std::ostream &os, InternedString s) -> std::ostream &;
+
+	// String interner following the design of lib/p0/strintern.
+	//
+	// Every distinct string is copied once into storage owned by the
+	// interner and is never freed, so no other string can alias it. Strings
+	// are ordered by shortlex, which is cheaper than dictionary order.
+	class Interner {
+	public:
+		auto intern(std::string_view s) -> InternedString;
+
+		// Number of distinct strings interned so far.
+		auto size() const -> std::size_t;
+
+	private:
+		struct Shortlex {
+			bool operator()(std::string_view a, std::string_view b) const;
+		};
+
+		Arena arena_;
+		std::map<std::string_view, std::uint32_t, Shortlex> strings_;
+	};
+
+} // namespace Primordial
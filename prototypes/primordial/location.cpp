@@ -0,0 +1,45 @@
+#include <algorithm>
+#include <cstring>
+#include "location.hpp"
+
+namespace Primordial {
+
+	auto operator<<(std::ostream &os, Location const &loc) -> std::ostream & {
+		return os << loc.begin << '-' << loc.end;
+	}
+
+	LineTable::LineTable(std::string_view text) : starts_{0} {
+		auto begin = text.data();
+		auto end = begin + text.size();
+		for (auto p = begin; p != end; ++p) {
+			p = static_cast<char const *>(std::memchr(p, '\n', end - p));
+			if (!p) {
+				break;
+			}
+
+			starts_.push_back(static_cast<std::uint32_t>(p + 1 - begin));
+		}
+	}
+
+	auto LineTable::position(std::uint32_t offset) const -> Position {
+		// The line is the last one that starts at or before the offset.
+		auto next = std::upper_bound(starts_.begin(), starts_.end(), offset);
+		auto line = static_cast<std::uint32_t>(next - starts_.begin());
+		return {line, offset - next[-1] + 1};
+	}
+
+	void LineTable::print(std::ostream &os, Location const &loc) const {
+		auto begin = position(loc.begin);
+		auto end = position(loc.end);
+
+		// The end is exclusive, but it is printed inclusively.
+		auto end_column = end.column > 1 ? end.column - 1 : 0;
+		os << begin.line << '.' << begin.column;
+		if (begin.line < end.line) {
+			os << '-' << end.line << '.' << end_column;
+		} else if (begin.column < end_column) {
+			os << '-' << end_column;
+		}
+	}
+
+} // namespace Primordial
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace Primordial {
+
+	// A range of a source file, as byte offsets from its start.
+	//
+	// The lexer only needs to add the length of every token to track it,
+	// and it is a quarter of the size of a yy::location. Lines and columns
+	// are computed with a LineTable when they are needed, which is only
+	// for diagnostics.
+	struct Location {
+		std::uint32_t begin = 0;
+		std::uint32_t end = 0;
+	};
+
+	// Debug traces print the raw offsets.
+	auto operator<<(std::ostream &os, Location const &loc) -> std::ostream &;
+
+	// A line and a column, both starting at 1. Columns count bytes.
+	struct Position {
+		std::uint32_t line;
+		std::uint32_t column;
+	};
+
+	// The offsets at which the lines of a text start.
+	//
+	// It is built in a single pass over the text, and turns an offset into
+	// a position with a binary search.
+	class LineTable {
+	public:
+		explicit LineTable(std::string_view text);
+
+		auto position(std::uint32_t offset) const -> Position;
+
+		// Write a location in the same format as yy::location, e.g.,
+		// 2.9-15 for a range within a line.
+		void print(std::ostream &os, Location const &loc) const;
+
+	private:
+		std::vector<std::uint32_t> starts_;
+	};
+
+} // namespace Primordial
@@ -1,18 +1,297 @@
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "allocations.hpp"
+#include "emit.hpp"
+#include "pool.hpp"
 #include "primordial.hpp"
 
-int main(int argc, char *argv[]) {
-	Primordial::Driver drv;
-	if (argc > 1 && strcmp(argv[1], "-v") == 0) {
+// Usage:
+//   parse [-v] [-j jobs] [--cache-dir dir] [--stats] [--lazy] [--stream]
+//         [--imports] [file...]
+//
+// Without files, parse standard input. With a cache directory, successful
+// parses are stored there and loaded instead of parsing unchanged files.
+// With several files, parse them in parallel and print the output of each
+// file after a header with its path, in the order given. Each output is
+// printed as soon as the file and all the files before it are done.
+//
+// Syntax errors are reported in the output, not in the exit status, which is
+// that of the first file that failed for another reason, such as not being
+// readable. Both the output and the status are deterministic.
+//
+// With --stats, the statistics of every file are written to standard error
+// as a line of JSON, in the same order as the output.
+//
+// With --lazy, the bodies of top-level functions are skipped and then parsed
+// one by one, which must give the same output as parsing the whole file.
+//
+// With --stream, imports and top-level items are printed as soon as they are
+// parsed, one per line, and the file is printed without them.
+//
+// With --imports, only the package clause and the imports are parsed, and
+// only the head of every file is read. The output is the same as that of a
+// full parse for valid files.
+
+// Exit status for files that cannot be read or are too large.
+static constexpr int io_error_status = 2;
+
+// Options of the command line that apply to every file.
+struct Options {
+	bool debug = false;
+	bool stats = false;
+	bool lazy = false;
+	bool stream = false;
+	bool imports = false;
+	Primordial::Cache const *cache = nullptr;
+};
+
+static void configure(Primordial::Driver &drv, Options const &options) {
+	drv.set_cache(options.cache);
+	drv.set_lazy_bodies(options.lazy);
+	if (options.debug) {
 		drv.enable_debug();
 	}
+}
+
+static auto item_kind_string(Primordial::Item::Kind kind) -> std::string_view {
+	using Kind = Primordial::Item::Kind;
+	switch (kind) {
+		case Kind::IMPORT: return "IMPORT";
+		case Kind::TYPE_DEF: return "TYPE_DEF";
+		case Kind::TYPE_DECL: return "TYPE_DECL";
+		case Kind::FUNCTION_DEF: return "FUNCTION_DEF";
+		case Kind::FUNCTION_DECL: return "FUNCTION_DECL";
+		case Kind::LET: return "LET";
+		case Kind::VAR: return "VAR";
+	}
+
+	return "UNKNOWN";
+}
+
+// Print a streamed item. Imports are printed as in files, and the rest by
+// their kind and name.
+static void print_item(
+	AST::Emitter &emitter,
+	std::ostream &out,
+	Primordial::Item const &item
+) {
+	if (item.node != AST::none) {
+		emitter.emit(item.tree, item.node);
+		emitter.flush();
+		return;
+	}
+
+	out << item_kind_string(item.kind);
+	if (!item.name.empty()) {
+		out << ' ' << item.name.view();
+	}
+
+	out << '\n';
+}
+
+// Parse the bodies skipped by a lazy parse, up to the first one that fails.
+static int parse_bodies(
+	Primordial::Driver &drv,
+	Primordial::Result const &file
+) {
+	for (auto const &body : file.bodies()) {
+		if (int status = drv.parse_body(file, body)) {
+			return status;
+		}
+	}
+
+	return 0;
+}
+
+// Parse a file, or standard input if path is null, and print the result.
+//
+// If stats_out is not null, the statistics of the file are written to it.
+static int parse(
+	Primordial::Driver &drv,
+	char const *path,
+	std::ostream &out,
+	std::ostream *stats_out,
+	Options const &options
+) {
+	using Clock = std::chrono::steady_clock;
+
+	Primordial::Stats stats;
+	auto const allocations_before = Primordial::thread_allocations();
+	drv.set_stats(stats_out ? &stats : nullptr);
+
+	AST::Emitter item_emitter(out);
+	if (options.stream) {
+		drv.set_item_callback([&](Primordial::Item const &item) {
+			print_item(item_emitter, out, item);
+		});
+	}
+
+	int status;
+	try {
+		if (options.imports) {
+			status = path ? drv.prescan_file(path) : drv.prescan();
+		} else {
+			status = path ? drv.parse_file(path) : drv.parse();
+		}
+	} catch (std::system_error const &e) {
+		drv.diagnostics() << e.what() << "\n";
+		status = io_error_status;
+	} catch (std::length_error const &e) {
+		drv.diagnostics() << e.what() << "\n";
+		status = io_error_status;
+	}
 
-	if (drv.parse() == 0) {
-		auto result = drv.result();
-		result->print(std::cout, 0);
-		std::cout << "\nPASS\n\n";
-	} else {
-		std::cout << "\nFAIL\n\n";
+	Primordial::Result result;
+	if (status == 0) {
+		result = drv.result();
+		status = parse_bodies(drv, result);
 	}
+
+	drv.set_stats(nullptr);
+	drv.set_item_callback(nullptr);
+	if (status == 0) {
+		if (stats_out) {
+			stats.count_nodes(*result);
+		}
+
+		auto start = Clock::now();
+		AST::Emitter emitter(out);
+		emitter.emit(*result);
+		emitter.flush();
+		out << "\nPASS\n\n";
+		stats.print = Clock::now() - start;
+
+		start = Clock::now();
+		result = {};
+		stats.teardown = Clock::now() - start;
+	} else if (status == 1) {
+		out << "\nFAIL\n\n";
+	}
+
+	if (stats_out) {
+		auto const allocations = Primordial::thread_allocations();
+		stats.allocations = allocations.count - allocations_before.count;
+		stats.allocated_bytes = allocations.bytes - allocations_before.bytes;
+		stats.write_json(*stats_out, path ? path : "-", status);
+	}
+
+	return status;
+}
+
+// Syntax errors are reported in the output, not in the exit status.
+static int exit_status_of(int status) {
+	return status == 1 ? 0 : status;
+}
+
+static int parse_files(
+	std::vector<char const *> const &paths,
+	unsigned jobs,
+	Options const &options
+) {
+	std::vector<std::unique_ptr<Primordial::Driver>> drivers(jobs);
+	std::vector<std::string> outputs(paths.size());
+	std::vector<std::string> stats_outputs(paths.size());
+	std::vector<int> statuses(paths.size());
+	std::vector<bool> done(paths.size());
+	std::mutex mutex;
+	std::size_t printed = 0;
+	int exit_status = 0;
+
+	Primordial::parallel_for(paths.size(), jobs, [&](unsigned w, auto i) {
+		if (!drivers[w]) {
+			drivers[w] = std::make_unique<Primordial::Driver>();
+			configure(*drivers[w], options);
+		}
+
+		std::ostringstream out;
+		std::ostringstream stats_out;
+		drivers[w]->set_diagnostics(out);
+		auto status = parse(
+			*drivers[w],
+			paths[i],
+			out,
+			options.stats ? &stats_out : nullptr,
+			options
+		);
+
+		std::lock_guard lock(mutex);
+		outputs[i] = std::move(out).str();
+		stats_outputs[i] = std::move(stats_out).str();
+		statuses[i] = status;
+		done[i] = true;
+		if (printed != i) {
+			return;
+		}
+
+		// Print every file that is no longer waiting for an earlier one.
+		for (; printed < paths.size() && done[printed]; ++printed) {
+			std::cout << "==> " << paths[printed] << " <==\n"
+				<< outputs[printed];
+			std::cerr << stats_outputs[printed];
+			std::string().swap(outputs[printed]);
+			std::string().swap(stats_outputs[printed]);
+			if (exit_status == 0) {
+				exit_status = exit_status_of(statuses[printed]);
+			}
+		}
+
+		std::cout.flush();
+	});
+
+	return exit_status;
+}
+
+int main(int argc, char *argv[]) {
+	Options options;
+	unsigned jobs = std::max(std::thread::hardware_concurrency(), 1u);
+	std::vector<char const *> paths;
+	std::unique_ptr<Primordial::Cache> cache;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "-v") == 0) {
+			options.debug = true;
+		} else if (strcmp(argv[i], "--stats") == 0) {
+			options.stats = true;
+		} else if (strcmp(argv[i], "--lazy") == 0) {
+			options.lazy = true;
+		} else if (strcmp(argv[i], "--stream") == 0) {
+			options.stream = true;
+		} else if (strcmp(argv[i], "--imports") == 0) {
+			options.imports = true;
+		} else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+			cache = std::make_unique<Primordial::Cache>(argv[++i]);
+		} else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+			jobs = std::max(std::atoi(argv[++i]), 1);
+		} else {
+			paths.push_back(argv[i]);
+		}
+	}
+
+	options.cache = cache.get();
+	if (paths.size() > 1) {
+		return parse_files(paths, jobs, options);
+	}
+
+	Primordial::Driver drv;
+	configure(drv, options);
+	drv.set_diagnostics(std::cout);
+
+	int status = parse(
+		drv,
+		paths.empty() ? nullptr : paths[0],
+		std::cout,
+		options.stats ? &std::cerr : nullptr,
+		options
+	);
+	return exit_status_of(status);
 }
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "pool.hpp"
+
+namespace Primordial {
+
+	// Remaining indices of one worker: [begin, end).
+	//
+	// Tasks are whole files, so a mutex per queue is cheap compared to the
+	// work being distributed.
+	class WorkQueue {
+	public:
+		WorkQueue(std::size_t begin, std::size_t end)
+		: begin_(begin), end_(end) {}
+
+		auto pop_front() -> std::optional<std::size_t> {
+			std::lock_guard lock(mutex_);
+			if (begin_ == end_) {
+				return std::nullopt;
+			}
+
+			return begin_++;
+		}
+
+		auto pop_back() -> std::optional<std::size_t> {
+			std::lock_guard lock(mutex_);
+			if (begin_ == end_) {
+				return std::nullopt;
+			}
+
+			return --end_;
+		}
+
+	private:
+		std::mutex mutex_;
+		std::size_t begin_;
+		std::size_t end_;
+	};
+
+	void parallel_for(
+		std::size_t n,
+		unsigned workers,
+		std::function<void(unsigned worker, std::size_t i)> const &task
+	) {
+		workers = static_cast<unsigned>(
+			std::clamp<std::size_t>(n, 1, std::max(workers, 1u))
+		);
+
+		std::vector<std::unique_ptr<WorkQueue>> queues;
+		for (unsigned w = 0; w < workers; ++w) {
+			queues.push_back(std::make_unique<WorkQueue>(
+				n * w / workers,
+				n * (w + 1) / workers
+			));
+		}
+
+		auto run = [&](unsigned w) {
+			while (auto i = queues[w]->pop_front()) {
+				task(w, *i);
+			}
+
+			// Steal from the other workers, starting with the next one so
+			// that thieves spread out instead of all hitting worker 0.
+			for (unsigned k = 1; k < workers; ++k) {
+				auto &victim = *queues[(w + k) % workers];
+				while (auto i = victim.pop_back()) {
+					task(w, *i);
+				}
+			}
+		};
+
+		std::vector<std::jthread> threads;
+		for (unsigned w = 1; w < workers; ++w) {
+			threads.emplace_back(run, w);
+		}
+
+		run(0);
+	}
+
+} // namespace Primordial
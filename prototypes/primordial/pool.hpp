@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace Primordial {
+
+	// Run task(worker, i) for every i in [0, n) on the given number of
+	// worker threads, and wait for all of them to finish.
+	//
+	// Each worker starts with a contiguous share of the indices and takes
+	// them from the front. Once its share is exhausted, it steals from the
+	// back of the share of another worker, so that a few slow tasks do not
+	// leave the other threads idle. The worker number is in [0, workers)
+	// and can be used to index per-thread state.
+	void parallel_for(
+		std::size_t n,
+		unsigned workers,
+		std::function<void(unsigned worker, std::size_t i)> const &task
+	);
+
+} // namespace Primordial
@@ -1,3 +1,7 @@
+#include <chrono>
+#include <iostream>
+#include <utility>
+#include <unistd.h>
 #include "primordial.hpp"
 #include "scanner.hpp"
 #include "parser.hpp"
@@ -5,28 +9,280 @@
 
 namespace Primordial {
 
-	Driver::Driver() {
-		yylex_init(&lexer);
-		loc = new yy::location();
-		parser = new yy::Parser(lexer, *loc, *this);
+	Result::Result(
+		std::unique_ptr<Source> &&source,
+		AST::Tree &&tree,
+		std::shared_ptr<Interner const> interner,
+		std::vector<FunctionBody> &&bodies
+	)
+	: source_(std::move(source))
+	, tree_(std::move(tree))
+	, interner_(std::move(interner))
+	, bodies_(std::move(bodies)) {}
+
+	Result::operator bool() const {
+		return tree_.root() != AST::none;
+	}
+
+	auto Result::operator*() const -> AST::Tree const & {
+		return tree_;
+	}
+
+	auto Result::operator->() const -> AST::Tree const * {
+		return &tree_;
+	}
+
+	auto Result::text() const -> std::string_view {
+		return source_ ? source_->text() : std::string_view();
+	}
+
+	auto Result::bodies() const -> std::span<FunctionBody const> {
+		return bodies_;
+	}
+
+	Driver::Driver()
+	: interner_(std::make_shared<Interner>()), diagnostics_(&std::cerr) {
+		yylex_init_extra(this, &lexer);
+		parser = new yy::Parser(lexer, loc, *this);
 	}
 
 	Driver::~Driver() {
 		yylex_destroy(lexer);
-		delete loc;
 		delete parser;
 	}
 
 	int Driver::parse() {
-		return parser->parse();
+		return parse(Source::read(STDIN_FILENO));
+	}
+
+	int Driver::parse_file(std::string const &path) {
+		return parse(Source::map(path));
+	}
+
+	int Driver::parse_body(Result const &file, FunctionBody const &body) {
+		auto range = body.range;
+		auto text = file.text().substr(range.begin, range.end - range.begin);
+		return parse(
+			Source::copy(text),
+			file.text(),
+			range.begin,
+			Start::FUNCTION_BODY
+		);
+	}
+
+	int Driver::prescan_file(std::string const &path) {
+		for (auto size = prescan_size;; size *= 2) {
+			auto source = Source::head(path, size);
+			if (!source->truncated()) {
+				return prescan(std::move(source));
+			}
+
+			// The last token read may have been cut, and so may the
+			// imports if the parse failed. Streamed imports are only
+			// delivered by the attempt that is kept, which parses the
+			// head again.
+			auto end = static_cast<std::uint32_t>(source->text().size());
+			auto head = item_callback_ ? Source::copy(source->text())
+				: nullptr;
+			auto callback = std::exchange(item_callback_, nullptr);
+			auto status = prescan(std::move(source));
+			item_callback_ = std::move(callback);
+			if (status == 0 && loc.end < end) {
+				return head ? prescan(std::move(head)) : status;
+			}
+		}
+	}
+
+	int Driver::prescan() {
+		return prescan(Source::read(STDIN_FILENO));
+	}
+
+	int Driver::prescan(std::unique_ptr<Source> &&source) {
+		auto text = source->text();
+		return parse(std::move(source), text, 0, Start::PRESCAN);
+	}
+
+	int Driver::parse(std::unique_ptr<Source> &&source) {
+		auto text = source->text();
+		return parse(std::move(source), text, 0, Start::FILE);
+	}
+
+	int Driver::parse(
+		std::unique_ptr<Source> &&source,
+		std::string_view file_text,
+		std::uint32_t offset,
+		Start symbol
+	) {
+		// Start every parse with a fresh tree so that the nodes of a
+		// failed parse are not kept alive by the next result.
+		tree_ = AST::Tree();
+		source_ = std::move(source);
+		file_text_ = file_text;
+		lines_.reset();
+		loc = Location{offset, offset};
+		can_insert_semicolon = false;
+		body_finder = BodyFinder();
+		start = symbol;
+		skipping_bodies_ = lazy_bodies_ && symbol == Start::FILE;
+		defer_errors_ = skipping_bodies_ || source_->truncated();
+		bodies_.clear();
+
+		// Bodies are part of the file that was already counted.
+		if (stats_ && symbol == Start::FILE) {
+			stats_->bytes = source_->text().size();
+		}
+
+		// Neither lazy nor streaming parses keep everything, and bodies
+		// are not files.
+		auto const use_cache = cache_ && !lazy_bodies_ && !item_callback_
+			&& symbol == Start::FILE;
+		std::string key;
+		if (use_cache) {
+			key = cache_->key(source_->text());
+			auto entry = cache_->load(key, *interner_);
+			if (entry.mapping) {
+				// Nothing refers to the source text anymore.
+				source_ = std::move(entry.mapping);
+				tree_ = std::move(entry.tree);
+				return 0;
+			}
+		}
+
+		// The lexer is called from the parser, so its time is subtracted.
+		auto start = std::chrono::steady_clock::now();
+		auto lex_before = stats_ ? stats_->lex : Stats::Duration{};
+		auto buffer = yy_scan_buffer(
+			source_->scan_buffer(),
+			source_->scan_buffer_size(),
+			lexer
+		);
+		int status;
+		try {
+			status = parser->parse();
+		} catch (LexicalError const &e) {
+			status = e.status;
+		} catch (DeferredError const &) {
+			status = 1;
+		}
+
+		yy_delete_buffer(buffer, lexer);
+		// Files that fail lazily fail in full too, so the items that were
+		// already streamed are not streamed again.
+		if (status != 0 && skipping_bodies_) {
+			auto callback = std::exchange(item_callback_, nullptr);
+			lazy_bodies_ = false;
+			status = parse(std::move(source_), file_text, offset, symbol);
+			lazy_bodies_ = true;
+			item_callback_ = std::move(callback);
+			return status;
+		}
+
+		if (stats_) {
+			auto elapsed = std::chrono::steady_clock::now() - start;
+			stats_->parse += elapsed - (stats_->lex - lex_before);
+		}
+
+		if (status == 0 && use_cache) {
+			cache_->store(key, tree_);
+		}
+
+		return status;
+	}
+
+	void Driver::set_result(AST::NodeId file) {
+		tree_.complete(file);
+	}
+
+	auto Driver::result() -> Result {
+		return Result(
+			std::move(source_),
+			std::exchange(tree_, AST::Tree()),
+			interner_,
+			std::move(bodies_)
+		);
+	}
+
+	auto Driver::tree() -> AST::Tree & {
+		return tree_;
+	}
+
+	auto Driver::interner() -> Interner & {
+		return *interner_;
+	}
+
+	auto Driver::diagnostics() -> std::ostream & {
+		return *diagnostics_;
+	}
+
+	void Driver::set_diagnostics(std::ostream &os) {
+		diagnostics_ = &os;
+	}
+
+	void Driver::syntax_error(
+		Location const &loc,
+		std::string const &message
+	) {
+		if (defer_errors_) {
+			throw DeferredError{};
+		}
+
+		if (!lines_) {
+			lines_.emplace(file_text_);
+		}
+
+		lines_->print(*diagnostics_, loc);
+		*diagnostics_ << ": " << message << std::endl;
+	}
+
+	void Driver::skip_body(InternedString name, Location const &range) {
+		bodies_.push_back(FunctionBody{name, range});
+	}
+
+	void Driver::set_item_callback(ItemCallback callback) {
+		item_callback_ = std::move(callback);
+	}
+
+	void Driver::add_import(AST::NodeId import, Location const &range) {
+		if (!item_callback_) {
+			tree_.push(import);
+			return;
+		}
+
+		item_callback_(Item{Item::Kind::IMPORT, range, {}, tree_, import});
+		tree_.clear();
+	}
+
+	void Driver::add_item(
+		Item::Kind kind,
+		Location const &range,
+		InternedString name
+	) {
+		if (!item_callback_) {
+			return;
+		}
+
+		item_callback_(Item{kind, range, name, tree_, AST::none});
+		tree_.clear();
+	}
+
+	void Driver::set_lazy_bodies(bool lazy) {
+		lazy_bodies_ = lazy;
+	}
+
+	auto Driver::skipping_bodies() const -> bool {
+		return skipping_bodies_;
+	}
+
+	void Driver::set_cache(Cache const *cache) {
+		cache_ = cache;
 	}
 
-	void Driver::set_result(std::unique_ptr<AST::File> &&file) {
-		result_ = std::move(file);
+	void Driver::set_stats(Stats *stats) {
+		stats_ = stats;
 	}
 
-	auto Driver::result() -> std::unique_ptr<AST::File> {
-		return std::move(result_);
+	auto Driver::stats() -> Stats * {
+		return stats_;
 	}
 
 	void Driver::enable_debug() {
@@ -1,30 +1,267 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
 #include "ast.hpp"
+#include "cache.hpp"
+#include "intern.hpp"
+#include "location.hpp"
+#include "source.hpp"
+#include "stats.hpp"
 
 namespace yy {
     class Parser;
-    class location;
 }
 
 namespace Primordial {
 
+	// The body of a top-level function that was skipped by a lazy parse.
+	// Its range goes from the "{" to the "}", both included.
+	struct FunctionBody {
+		InternedString name;
+		Location range;
+	};
+
+	// An import or a top-level item, delivered by streaming parses as soon
+	// as it has been parsed.
+	//
+	// Its nodes are in the tree of the driver, which is cleared when the
+	// callback returns, so items must not be kept. Only imports have a
+	// node yet, but the nodes of the types and expressions of the other
+	// items are in the tree too.
+	struct Item {
+		enum class Kind {
+			IMPORT,
+			TYPE_DEF,
+			TYPE_DECL,
+			FUNCTION_DEF,
+			FUNCTION_DECL,
+			LET,
+			VAR,
+		};
+
+		Kind kind;
+		Location range;
+
+		// Name of types and functions, empty for the rest.
+		InternedString name;
+
+		AST::Tree const &tree;
+
+		// The import, or none for the rest.
+		AST::NodeId node;
+	};
+
+	// The result of a successful parse.
+	//
+	// The result owns the tree, whose root is the file. The interner is
+	// shared with the Driver and with any other results it produced, so
+	// that names from different files can be compared too. Literals point
+	// into the source text, which the result also keeps.
+	class Result {
+	public:
+		Result() = default;
+		Result(
+			std::unique_ptr<Source> &&source,
+			AST::Tree &&tree,
+			std::shared_ptr<Interner const> interner,
+			std::vector<FunctionBody> &&bodies = {}
+		);
+
+		explicit operator bool() const;
+		auto operator*() const -> AST::Tree const &;
+		auto operator->() const -> AST::Tree const *;
+
+		// Source text of the file, unless it was loaded from a cache.
+		auto text() const -> std::string_view;
+
+		// Bodies skipped by a lazy parse, in source order.
+		auto bodies() const -> std::span<FunctionBody const>;
+
+	private:
+		std::unique_ptr<Source> source_;
+		AST::Tree tree_;
+		std::shared_ptr<Interner const> interner_;
+		std::vector<FunctionBody> bodies_;
+	};
+
+	// Lexer state to find the bodies of top-level functions, which lazy
+	// parses skip. A body starts with the first "{" outside of brackets
+	// after a "func" that starts an item.
+	struct BodyFinder {
+		bool at_item_start = true;
+		bool in_signature = false;
+		std::uint32_t nesting = 0;
+
+		// Braces open in the body being skipped, and where it started.
+		std::uint32_t depth = 0;
+		std::uint32_t begin = 0;
+
+		auto at_body() const -> bool {
+			return in_signature && nesting == 0;
+		}
+	};
+
+	// Thrown by the lexer to abort the parse on a lexical error.
+	struct LexicalError {
+		int status;
+	};
+
+	// Thrown instead of reporting errors in parses that are retried when
+	// they fail. Lazy parses are retried without skipping bodies, so that
+	// errors are reported exactly as in a full parse, and prescans of the
+	// head of a file are retried with more of it.
+	struct DeferredError {};
+
+	// Drivers do not share any mutable state, so each thread can parse
+	// with its own driver.
 	class Driver {
 	public:
 		Driver();
 		~Driver();
 
+		// Parse standard input.
+		//
+		// Returns 0 on success, 1 on syntax errors, and 41 or 42 on
+		// lexical errors (invalid character and unknown operator).
 		int parse();
+
+		// Parse a file, which is mapped into memory when possible.
+		//
+		// Throws std::system_error if the file cannot be read.
+		int parse_file(std::string const &path);
+
+		// Skip the bodies of top-level functions in the next parses, and
+		// record their ranges in the result instead. Only strings and
+		// comments are recognised in the bodies, so the errors in them are
+		// not found until they are parsed with parse_body. Files with other
+		// errors are parsed again in full to report them.
+		//
+		// Lazy parses bypass the cache, which does not keep the bodies.
+		void set_lazy_bodies(bool lazy);
+
+		// Whether the file currently being parsed skips bodies.
+		auto skipping_bodies() const -> bool;
+
+		// Parse a body skipped by a lazy parse of a file, with the same
+		// grammar and statuses as parse. Locations are offsets in the
+		// file, so diagnostics point into it.
+		//
+		// Statements do not have nodes yet, so the tree of the next
+		// result only holds the expressions and types of the body, and
+		// its root is none.
+		int parse_body(Result const &file, FunctionBody const &body);
+
+		// Parse only the package clause and the imports of a file, and
+		// stop at whatever follows them. The file of the result has the
+		// same package name and imports as that of a full parse, but the
+		// rest of the file is not checked.
+		//
+		// Only the head of the file is read, starting with prescan_size
+		// bytes and doubling them until the imports are complete.
+		//
+		// Throws std::system_error if the file cannot be read.
+		int prescan_file(std::string const &path);
+
+		// Prescan standard input, which has to be read in full.
+		int prescan();
+
+		static constexpr std::size_t prescan_size = 4096;
+
 		void enable_debug();
-		auto result() -> std::unique_ptr<AST::File>;
-		void set_result(std::unique_ptr<AST::File> &&file);
+		auto result() -> Result;
+		void set_result(AST::NodeId file);
+
+		// Tree of the file currently being parsed.
+		auto tree() -> AST::Tree &;
+
+		// Interner for identifiers, shared by every file parsed by this
+		// driver.
+		auto interner() -> Interner &;
+
+		// Stream for syntax error messages. Defaults to std::cerr.
+		auto diagnostics() -> std::ostream &;
+		void set_diagnostics(std::ostream &os);
+
+		// Report a syntax error in the file currently being parsed.
+		void syntax_error(Location const &loc, std::string const &message);
+
+		// Record a function body skipped by the lexer.
+		void skip_body(InternedString name, Location const &range);
+
+		// Deliver the imports and top-level items of the next parses to a
+		// callback as they are parsed, instead of keeping them, so that
+		// files of any size are parsed in bounded memory. The file of the
+		// result then only has the package name. Null stops streaming.
+		//
+		// Streaming parses bypass the cache, which would skip the items.
+		using ItemCallback = std::function<void(Item const &)>;
+		void set_item_callback(ItemCallback callback);
+
+		// Called by the parser for every import and top-level item.
+		void add_import(AST::NodeId import, Location const &range);
+		void add_item(
+			Item::Kind kind,
+			Location const &range,
+			InternedString name = {}
+		);
+
+		// Look up successful parses in a cache and store new ones. The
+		// cache is not owned by the driver and can be shared.
+		void set_cache(Cache const *cache);
+
+		// Collect statistics about the next parses into a Stats object,
+		// which is not owned by the driver. Null stops collecting them.
+		void set_stats(Stats *stats);
+		auto stats() -> Stats *;
+
+		// Lexer state for the implicit semicolon rule.
+		bool can_insert_semicolon = false;
+
+		// Lexer state for lazy parses.
+		BodyFinder body_finder;
+
+		// What the grammar parses, which the lexer selects with its first
+		// token. None once it has been returned.
+		enum class Start { NONE, FILE, FUNCTION_BODY, PRESCAN };
+		Start start = Start::NONE;
 
 	private:
+		int parse(std::unique_ptr<Source> &&source);
+		int prescan(std::unique_ptr<Source> &&source);
+		int parse(
+			std::unique_ptr<Source> &&source,
+			std::string_view file_text,
+			std::uint32_t offset,
+			Start symbol
+		);
+
 		void* lexer;
-		yy::location* loc;
+		Location loc;
 		yy::Parser* parser;
-		std::unique_ptr<AST::File> result_;
+		std::unique_ptr<Source> source_;
+
+		// Text of the whole file for diagnostics, which is not that of
+		// the source when parsing a body.
+		std::string_view file_text_;
+
+		// Only built when the current file has errors.
+		std::optional<LineTable> lines_;
+		AST::Tree tree_;
+		std::shared_ptr<Interner> interner_;
+		std::ostream *diagnostics_;
+		Cache const *cache_ = nullptr;
+		Stats *stats_ = nullptr;
+		bool lazy_bodies_ = false;
+		bool skipping_bodies_ = false;
+		bool defer_errors_ = false;
+		ItemCallback item_callback_;
+		std::vector<FunctionBody> bodies_;
 	};
 
 } // namespace Primordial
@@ -70,16 +70,17 @@
 %define parse.trace
 %define parse.error detailed
 
-%lex-param {void *scanner} {yy::location &loc}
-%parse-param {void *scanner} {yy::location &loc} {Primordial::Driver &drv}
+%define api.location.type {Primordial::Location}
+%lex-param {void *scanner} {Primordial::Location &loc}
+%parse-param {void *scanner} {Primordial::Location &loc}
+%parse-param {Primordial::Driver &drv}
 
 %code requires {
 
 #include <algorithm>
 #include <functional>
-#include <iterator>
-#include <list>
 #include <string>
+#include "location.hpp"
 #include "primordial.hpp"
 #include "ast.hpp"
 
@@ -89,14 +90,38 @@
 
 #include "scanner.hpp"
 
-yy::Parser::symbol_type yylex(void* yyscanner, yy::location& loc);
+yy::Parser::symbol_type yylex(void* yyscanner, Primordial::Location& loc);
+
+// Every reduction computes the location of its left-hand side first, while
+// the right-hand side is still on the stack. The stack only grows between
+// reductions, so this is where its peaks can be sampled.
+#define YYLLOC_DEFAULT(Current, Rhs, N)\
+	do {\
+		if (N) {\
+			(Current).begin = YYRHSLOC(Rhs, 1).begin;\
+			(Current).end = YYRHSLOC(Rhs, N).end;\
+		} else {\
+			(Current).begin = (Current).end = YYRHSLOC(Rhs, 0).end;\
+		}\
+		if (auto *stats = drv.stats()) {\
+			stats->sample_stack_depth(yystack_.size());\
+		}\
+	} while (false)
 
 }
 
-%start File
+%start Start
 
 %token END 0
 
+/* Function bodies skipped by lazy parses. */
+%token SKIPPED_BODY "function body"
+
+/* The lexer starts with one of these to select what to parse. */
+%token FILE_START "start of file"
+%token BODY_START "start of function body"
+%token PRESCAN_START "start of prescan"
+
 /* Separators */
 %token LPAR "("
 %token RPAR ")"
@@ -157,111 +182,137 @@ yy::Parser::symbol_type yylex(void* yyscanner, yy::location& loc);
 %token GOTO "goto"
 
 /* Identifiers */
-%token <std::string> UPPER_ID "upper identifier"
-%token <std::string> LOWER_ID "lower identifier"
+%token <Primordial::InternedString> UPPER_ID "upper identifier"
+%token <Primordial::InternedString> LOWER_ID "lower identifier"
 
 /* Literals */
 %token <bool> BOOLEAN_LITERAL "Boolean literal"
-%token <std::string> NUMERIC_LITERAL "numeric literal"
-%token <std::string> STRING_LITERAL "string literal"
+%token <std::string_view> NUMERIC_LITERAL "numeric literal"
+%token <std::string_view> STRING_LITERAL "string literal"
 
 /* Non-terminals */
-%nterm <std::string> PackageDecl
-%nterm <std::vector<AST::Import>> ImportList
-%nterm <std::vector<AST::Import>> ImportGroup
-%nterm <AST::Import> Import
-
-%nterm <std::unique_ptr<AST::Type>> Type
-%nterm <std::unique_ptr<AST::Type>> CompoundLiteralType
-
-%nterm <AST::TypeList> NETypeList
-%nterm <AST::TypeList> XTypeList
-
-%nterm <std::unique_ptr<AST::TypeName>> TypeName
-%nterm <std::unique_ptr<AST::QualifiedTypeName>> QualifiedTypeName
-%nterm <std::unique_ptr<AST::TypeInstantiation>> TypeInstantiation
-%nterm <std::unique_ptr<AST::ArrayType>> ArrayType
-%nterm <std::unique_ptr<AST::SliceType>> SliceType
-%nterm <std::unique_ptr<AST::RawSliceType>> RawSliceType
-%nterm <std::unique_ptr<AST::PointerType>> PointerType
-%nterm <std::unique_ptr<AST::FunctionType>> FunctionType
-%nterm <std::unique_ptr<AST::StructType>> StructType
-%nterm <std::unique_ptr<AST::UnionType>> UnionType
-%nterm <std::unique_ptr<AST::InterfaceType>> InterfaceType
-
-%nterm <AST::Field> Field
-%nterm <std::vector<AST::Field>> FieldList
-%nterm <std::vector<AST::Field>> XFieldList
-
-// We cannot use concrete types here because of embedding higher-precedence
-// expressions in lower-precedence expressions.
-%nterm <std::unique_ptr<AST::Expression>> Expression
-%nterm <std::unique_ptr<AST::Expression>> AndExpression
-%nterm <std::unique_ptr<AST::Expression>> RelExpression
-%nterm <std::unique_ptr<AST::Expression>> SumExpression
-%nterm <std::unique_ptr<AST::Expression>> MulExpression
-%nterm <std::unique_ptr<AST::Expression>> UnaryExpression
-%nterm <std::unique_ptr<AST::Expression>> Term
-%nterm <std::unique_ptr<AST::Expression>> Literal
-
-// Leaves in the expression hierarchy can have concrete types.
-%nterm <std::unique_ptr<AST::Expression>> FunctionCall
-%nterm <std::unique_ptr<AST::ArrayAccess>> ArrayAccess
-%nterm <std::unique_ptr<AST::FieldAccess>> FieldAccess
-%nterm <std::unique_ptr<AST::PackageAccess>> PackageAccess
-%nterm <std::unique_ptr<AST::Expression>> AnonymousFunctionDef
-%nterm <std::unique_ptr<AST::PointerDereference>> PointerDereference
-%nterm <std::unique_ptr<AST::TypeCast>> TypeCast
-%nterm <std::unique_ptr<AST::Expression>> SymbolAccess
-
-%nterm <AST::ExpressionList> ExpressionList
-%nterm <AST::ExpressionList> NEExpressionList
-%nterm <AST::ExpressionList> XExpressionList
-
-%nterm <AST::FieldAssignment> FieldAssignment
-%nterm <AST::FieldAssignmentList> NEFieldAssignmentList
-%nterm <AST::FieldAssignmentList> XFieldAssignmentList
+
+// The semantic values that refer to the tree are 32-bit indices: nodes
+// are identified by their AST::NodeId, finished lists by their AST::ListId,
+// and lists that are still being parsed by their mark in the scratch stack
+// of the tree. Bison needs all of them to be spelled the same.
+%nterm <Primordial::InternedString> TypeDef
+%nterm <Primordial::InternedString> TypeDecl
+%nterm <Primordial::InternedString> FunctionDef
+%nterm <Primordial::InternedString> FunctionDecl
+%nterm <bool> FunctionBody
+%nterm <Primordial::InternedString> PackageDecl
+%nterm <std::uint32_t> ImportList
+%nterm <std::uint32_t> ImportGroup
+%nterm <std::uint32_t> Import
+
+%nterm <std::uint32_t> Type
+%nterm <std::uint32_t> CompoundLiteralType
+
+%nterm <std::uint32_t> NETypeList
+%nterm <std::uint32_t> XTypeList
+
+%nterm <std::uint32_t> TypeName
+%nterm <std::uint32_t> QualifiedTypeName
+%nterm <std::uint32_t> TypeInstantiation
+%nterm <std::uint32_t> ArrayType
+%nterm <std::uint32_t> SliceType
+%nterm <std::uint32_t> RawSliceType
+%nterm <std::uint32_t> PointerType
+%nterm <std::uint32_t> FunctionType
+%nterm <std::uint32_t> StructType
+%nterm <std::uint32_t> UnionType
+%nterm <std::uint32_t> InterfaceType
+
+%nterm <std::uint32_t> Field
+%nterm <std::uint32_t> FieldList
+%nterm <std::uint32_t> XFieldList
+
+%nterm <std::uint32_t> Expression
+%nterm <std::uint32_t> OperandSequence
+%nterm <AST::BinaryOperator> BinaryOperator
+%nterm <std::uint32_t> UnaryExpression
+%nterm <std::uint32_t> Term
+%nterm <std::uint32_t> Literal
+
+%nterm <std::uint32_t> FunctionCall
+%nterm <std::uint32_t> ArrayAccess
+%nterm <std::uint32_t> FieldAccess
+%nterm <std::uint32_t> PackageAccess
+%nterm <std::uint32_t> AnonymousFunctionDef
+%nterm <std::uint32_t> PointerDereference
+%nterm <std::uint32_t> TypeCast
+%nterm <std::uint32_t> SymbolAccess
+
+%nterm <std::uint32_t> ExpressionList
+%nterm <std::uint32_t> NEExpressionList
+%nterm <std::uint32_t> XExpressionList
+
+%nterm <std::uint32_t> FieldAssignment
+%nterm <std::uint32_t> NEFieldAssignmentList
+%nterm <std::uint32_t> XFieldAssignmentList
 
 %%
 
+// Bodies skipped by a lazy parse are parsed on their own. They do not have
+// a node yet, but the tree still has to be completed.
+Start
+	: FILE_START File
+	| BODY_START Block { drv.set_result(AST::none); }
+	| PRESCAN_START Header
+	;
+
+// Prescans stop at the first token after the imports, whatever it is, since
+// this rule is reduced by default when it is not another import.
+Header : PackageDecl ImportList {
+	auto &tree = drv.tree();
+	auto imports = tree.close_list($2);
+	drv.set_result(tree.add(AST::Kind::FILE, tree.add_name($1), imports));
+	YYACCEPT;
+};
+
 File : PackageDecl ImportList TopItems {
-	auto file = std::make_unique<AST::File>(std::move($1), std::move($2));
-	drv.set_result(std::move(file));
+	auto &tree = drv.tree();
+	auto imports = tree.close_list($2);
+	drv.set_result(tree.add(AST::Kind::FILE, tree.add_name($1), imports));
 };
 
 PackageDecl : "package" UPPER_ID ";" {
-	$$ = std::string(std::move($2));
+	$$ = $2;
 };
 
 ImportList : %empty {
-	// $$ was default constructed.
+	$$ = drv.tree().open_list();
 };
 
 ImportList : ImportList "import" Import ";" {
-	$$ = std::move($1);
-	$$.push_back(std::move($3));
+	$$ = $1;
+	drv.add_import($3, @3);
 };
 
+// Nothing else is pushed while the imports are parsed, so the items of the
+// group are already in place after those of the list.
 ImportList : ImportList "import" "(" ImportGroup ")" ";" {
-	$$ = std::move($1);
-	std::move(std::begin($4), std::end($4), std::back_inserter($$));
+	$$ = $1;
 };
 
 ImportGroup : %empty {
-	// $$ was default constructed.
+	$$ = drv.tree().open_list();
 };
 
 ImportGroup : ImportGroup Import ";"	{
-	$$ = std::move($1);
-	$$.push_back(std::move($2));
+	$$ = $1;
+	drv.add_import($2, @2);
 };
 
 Import : STRING_LITERAL {
-	$$ = AST::Import(std::move($1));
+	auto &tree = drv.tree();
+	$$ = tree.add(AST::Kind::IMPORT, tree.add_literal($1), AST::none);
 };
 
 Import : UPPER_ID STRING_LITERAL {
-	$$ = AST::Import(std::move($2), std::move($1));
+	auto &tree = drv.tree();
+	$$ = tree.add(AST::Kind::IMPORT, tree.add_literal($2), tree.add_name($1));
 };
 
 TopItems
@@ -270,12 +321,16 @@ TopItems
 	;
 
 TopItem
-	: TypeDef
-	| TypeDecl
-	| FunctionDef
-	| FunctionDecl
-	| Let
-	| Var
+	: TypeDef { drv.add_item(Primordial::Item::Kind::TYPE_DEF, @1, $1); }
+	| TypeDecl { drv.add_item(Primordial::Item::Kind::TYPE_DECL, @1, $1); }
+	| FunctionDef {
+		drv.add_item(Primordial::Item::Kind::FUNCTION_DEF, @1, $1);
+	}
+	| FunctionDecl {
+		drv.add_item(Primordial::Item::Kind::FUNCTION_DECL, @1, $1);
+	}
+	| Let { drv.add_item(Primordial::Item::Kind::LET, @1); }
+	| Var { drv.add_item(Primordial::Item::Kind::VAR, @1); }
 	;
 
 Let
@@ -315,22 +370,43 @@ VarDefinitionGroup
 	;
 
 TypeDef
-	: "type" UPPER_ID Type
-	| "type" UPPER_ID "[" NETypeArgList "]" Type
+	: "type" UPPER_ID Type { $$ = $2; }
+	| "type" UPPER_ID "[" NETypeArgList "]" Type { $$ = $2; }
 	;
 
 /* Potentially useful to define opaque types */
 TypeDecl
-	: "type" UPPER_ID
-	| "type" UPPER_ID "[" NETypeArgList "]"
-	| "type" UPPER_ID "[" NETypeList "]"
+	: "type" UPPER_ID { $$ = $2; }
+	| "type" UPPER_ID "[" NETypeArgList "]" { $$ = $2; }
+	| "type" UPPER_ID "[" NETypeList "]" { $$ = $2; }
 	;
 
 /* Methods cannot take generic parameters */
 FunctionDef
-	: "func" LOWER_ID FunctionSignature Block
-	| "func" LOWER_ID "[" NETypeArgList "]" FunctionSignature Block
-	| "func" Receiver LOWER_ID FunctionSignature Block
+	: "func" LOWER_ID FunctionSignature FunctionBody {
+		$$ = $2;
+		if ($4) {
+			drv.skip_body($2, @4);
+		}
+	}
+	| "func" LOWER_ID "[" NETypeArgList "]" FunctionSignature FunctionBody {
+		$$ = $2;
+		if ($7) {
+			drv.skip_body($2, @7);
+		}
+	}
+	| "func" Receiver LOWER_ID FunctionSignature FunctionBody {
+		$$ = $3;
+		if ($5) {
+			drv.skip_body($3, @5);
+		}
+	}
+	;
+
+// Whether the body was skipped by a lazy parse.
+FunctionBody
+	: Block { $$ = false; }
+	| SKIPPED_BODY { $$ = true; }
 	;
 
 // The parentheses aren't really necessary, but might provide a visual cue.
@@ -353,10 +429,10 @@ ReceiverType
  * compiler.
  */
 FunctionDecl
-	: "func" LOWER_ID FunctionSignature
-	| "func" LOWER_ID "[" NETypeArgList "]" FunctionSignature
-	| "func" LOWER_ID "[" NETypeList "]" FunctionSignature
-	| "func" Receiver LOWER_ID FunctionSignature
+	: "func" LOWER_ID FunctionSignature { $$ = $2; }
+	| "func" LOWER_ID "[" NETypeArgList "]" FunctionSignature { $$ = $2; }
+	| "func" LOWER_ID "[" NETypeList "]" FunctionSignature { $$ = $2; }
+	| "func" Receiver LOWER_ID FunctionSignature { $$ = $3; }
 	;
 
 FunctionSignature
@@ -464,12 +540,15 @@ XLowerIDList
 	;
 
 FunctionCall
-	: Term "(" ExpressionList ")" { /* TODO */ }
-	| Term "[" NETypeList "]" "(" ExpressionList ")" { /* TODO */ }
+	: Term "(" ExpressionList ")" { /* TODO */ $$ = AST::none; }
+	| Term "[" NETypeList "]" "(" ExpressionList ")" {
+		/* TODO */
+		$$ = AST::none;
+	}
 	;
 
 AnonymousFunctionDef
-	: "func" FunctionSignature Block { /* TODO */ }
+	: "func" FunctionSignature Block { /* TODO */ $$ = AST::none; }
 	;
 
 /*
@@ -522,274 +601,137 @@ Condition
 	: AssignmentSeq Expression
 	;
 
-Expression : AndExpression {
-	$$ = std::move($1);
-};
-
-Expression : Expression "||" AndExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::LOGICAL_AND,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-AndExpression : RelExpression {
- 	$$ = std::move($1);
-};
-
-AndExpression : AndExpression "&&" RelExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::LOGICAL_AND,
-		std::move($1),
-		std::move($3)
-	);
+// Binary expressions are parsed as a flat sequence of operands and
+// operators, and the tree orders them by precedence when the expression
+// ends. This takes a few reductions per operand regardless of the number
+// of precedence levels.
+Expression : OperandSequence {
+	$$ = drv.tree().close_expression($1);
 };
 
-RelExpression : SumExpression {
-	$$ = std::move($1);
+OperandSequence : UnaryExpression {
+	$$ = drv.tree().open_list();
+	drv.tree().push($1);
 };
 
-RelExpression : RelExpression "==" SumExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::EQ,
-		std::move($1),
-		std::move($3)
-	);
+OperandSequence : OperandSequence BinaryOperator UnaryExpression {
+	$$ = $1;
+	drv.tree().push($2);
+	drv.tree().push($3);
 };
 
-RelExpression : RelExpression "!=" SumExpression {
-$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::NE,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-RelExpression : RelExpression "<=" SumExpression {
-$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::LE,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-RelExpression : RelExpression ">=" SumExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::GE,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-RelExpression : RelExpression "<" SumExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::LT,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-RelExpression : RelExpression ">" SumExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::GT,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-SumExpression : MulExpression {
-	$$ = std::move($1);
-};
-
-SumExpression : SumExpression "+" MulExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::ADD,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-SumExpression : SumExpression "-" MulExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::SUB,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-SumExpression : SumExpression "|" MulExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::BITWISE_OR,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-SumExpression : SumExpression "^" MulExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::BITWISE_XOR,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-MulExpression : UnaryExpression {
-	$$ = std::move($1);
-};
-
-MulExpression : MulExpression "*" UnaryExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::MUL,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-MulExpression : MulExpression "/" UnaryExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::DIV,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-MulExpression : MulExpression "%" UnaryExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::REM,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-MulExpression : MulExpression "&" UnaryExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::BITWISE_AND,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-MulExpression : MulExpression "&^" UnaryExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::BITWISE_CLEAR,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-MulExpression : MulExpression "<<" UnaryExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::LEFT_SHIFT,
-		std::move($1),
-		std::move($3)
-	);
-};
-
-MulExpression : MulExpression ">>" UnaryExpression {
-	$$ = std::make_unique<AST::BinaryExpression>(
-		AST::BinaryOperator::RIGHT_SHIFT,
-		std::move($1),
-		std::move($3)
-	);
-};
+BinaryOperator
+	: "||" { $$ = AST::BinaryOperator::LOGICAL_OR; }
+	| "&&" { $$ = AST::BinaryOperator::LOGICAL_AND; }
+	| "==" { $$ = AST::BinaryOperator::EQ; }
+	| "!=" { $$ = AST::BinaryOperator::NE; }
+	| "<=" { $$ = AST::BinaryOperator::LE; }
+	| ">=" { $$ = AST::BinaryOperator::GE; }
+	| "<" { $$ = AST::BinaryOperator::LT; }
+	| ">" { $$ = AST::BinaryOperator::GT; }
+	| "+" { $$ = AST::BinaryOperator::ADD; }
+	| "-" { $$ = AST::BinaryOperator::SUB; }
+	| "|" { $$ = AST::BinaryOperator::BITWISE_OR; }
+	| "^" { $$ = AST::BinaryOperator::BITWISE_XOR; }
+	| "*" { $$ = AST::BinaryOperator::MUL; }
+	| "/" { $$ = AST::BinaryOperator::DIV; }
+	| "%" { $$ = AST::BinaryOperator::REM; }
+	| "&" { $$ = AST::BinaryOperator::BITWISE_AND; }
+	| "&^" { $$ = AST::BinaryOperator::BITWISE_CLEAR; }
+	| "<<" { $$ = AST::BinaryOperator::LEFT_SHIFT; }
+	| ">>" { $$ = AST::BinaryOperator::RIGHT_SHIFT; }
+	;
 
 UnaryExpression	: Term {
-	$$ = std::move($1);
+	$$ = $1;
 };
 
 UnaryExpression	: "-" UnaryExpression {
-	$$ = std::make_unique<AST::UnaryExpression>(
-		AST::UnaryOperator::NEG,
-		std::move($2)
-	);
+	$$ = drv.tree().add(AST::UnaryOperator::NEG, $2);
 };
 
 UnaryExpression	: "~" UnaryExpression {
-	$$ = std::make_unique<AST::UnaryExpression>(
-		AST::UnaryOperator::BITWISE_NOT,
-		std::move($2)
-	);
+	$$ = drv.tree().add(AST::UnaryOperator::BITWISE_NOT, $2);
 };
 
 UnaryExpression	: "!" UnaryExpression {
-	$$ = std::make_unique<AST::UnaryExpression>(
-		AST::UnaryOperator::LOGICAL_NOT,
-		std::move($2)
-	);
+	$$ = drv.tree().add(AST::UnaryOperator::LOGICAL_NOT, $2);
 };
 
 UnaryExpression	: "@" UnaryExpression {
-	$$ = std::make_unique<AST::UnaryExpression>(
-		AST::UnaryOperator::ADDRESS_OF,
-		std::move($2)
-	);
+	$$ = drv.tree().add(AST::UnaryOperator::ADDRESS_OF, $2);
 };
 
 Term
-	: "(" Expression ")" { $$ = std::move($2); }
-	| FunctionCall { $$ = std::move($1); }
-	| AnonymousFunctionDef { $$ = std::move($1); }
-	| ArrayAccess { $$ = std::move($1); }
-	| FieldAccess { $$ = std::move($1); }
-	| PackageAccess { $$ = std::move($1); }
-	| SymbolAccess { $$ = std::move($1); }
-	| PointerDereference { $$ = std::move($1); }
-	| TypeCast { $$ = std::move($1); }
-	| Literal { $$ = std::move($1); }
+	: "(" Expression ")" { $$ = $2; }
+	| FunctionCall { $$ = $1; }
+	| AnonymousFunctionDef { $$ = $1; }
+	| ArrayAccess { $$ = $1; }
+	| FieldAccess { $$ = $1; }
+	| PackageAccess { $$ = $1; }
+	| SymbolAccess { $$ = $1; }
+	| PointerDereference { $$ = $1; }
+	| TypeCast { $$ = $1; }
+	| Literal { $$ = $1; }
 	;
 
 ArrayAccess : Term "[" Expression "]" {
-	$$ = std::make_unique<AST::ArrayAccess>(
-		std::move($1),
-		std::move($3)
-	);
+	$$ = drv.tree().add(AST::Kind::ARRAY_ACCESS, $1, $3);
 };
 
 FieldAccess : Term "." LOWER_ID {
-	$$ = std::make_unique<AST::FieldAccess>(std::move($1), std::move($3));
+	auto &tree = drv.tree();
+	$$ = tree.add(AST::Kind::FIELD_ACCESS, $1, tree.add_name($3));
 };
 
 PackageAccess : UPPER_ID "." LOWER_ID {
-	$$ = std::make_unique<AST::PackageAccess>(std::move($1), std::move($3));
+	auto &tree = drv.tree();
+	$$ = tree.add(
+		AST::Kind::PACKAGE_ACCESS,
+		tree.add_name($1),
+		tree.add_name($3)
+	);
 };
 
 SymbolAccess : LOWER_ID {
-	$$ = std::make_unique<AST::SymbolAccess>(std::move($1));
+	auto &tree = drv.tree();
+	$$ = tree.add(AST::Kind::SYMBOL_ACCESS, tree.add_name($1));
 }
 
 Literal : BOOLEAN_LITERAL {
-	$$ = std::make_unique<AST::BooleanLiteral>($1);
+	$$ = drv.tree().add(AST::Kind::BOOLEAN_LITERAL, $1);
 };
 
 Literal : STRING_LITERAL {
-	$$ = std::make_unique<AST::StringLiteral>(std::move($1));
+	auto &tree = drv.tree();
+	$$ = tree.add(AST::Kind::STRING_LITERAL, tree.add_literal($1));
 };
 
 Literal : NUMERIC_LITERAL {
-	$$ = std::make_unique<AST::NumericLiteral>(std::move($1));
+	auto &tree = drv.tree();
+	$$ = tree.add(AST::Kind::NUMERIC_LITERAL, tree.add_literal($1));
 };
 
 // The empty struct and the empty list look identical, so we need to treat it
 // on its own to prevent ambiguities, and require non-emptiness from the rest.
 Literal : CompoundLiteralType "{" "}" {
-	$$ = std::make_unique<AST::EmptyCompoundLiteral>(std::move($1));
+	$$ = drv.tree().add(AST::Kind::EMPTY_COMPOUND_LITERAL, $1);
 };
 
 Literal	: CompoundLiteralType "{" NEFieldAssignmentList "}" {
-	$$ = std::make_unique<AST::RecordLiteral>(std::move($1), std::move($3));
+	$$ = drv.tree().add(AST::Kind::RECORD_LITERAL, $1, $3);
 };
 
 Literal : CompoundLiteralType "{" NEExpressionList "}" {
-	$$ = std::make_unique<AST::ListLiteral>(std::move($1), std::move($3));
+	$$ = drv.tree().add(AST::Kind::LIST_LITERAL, $1, $3);
 };
 
 PointerDereference : Term "." {
-	$$ = std::make_unique<AST::PointerDereference>(std::move($1));
+	$$ = drv.tree().add(AST::Kind::POINTER_DEREFERENCE, $1);
 };
 
 TypeCast : Type "(" Expression ")" {
-	$$ = std::make_unique<AST::TypeCast>(std::move($1), std::move($3));
+	$$ = drv.tree().add(AST::Kind::TYPE_CAST, $1, $3);
 };
 
 /*
@@ -801,43 +743,46 @@ TypeCast : Type "(" Expression ")" {
  * function definition.
  */
 CompoundLiteralType
-	: TypeName { $$ = std::move($1); }
-	| QualifiedTypeName { $$ = std::move($1); }
-	| TypeInstantiation { $$ = std::move($1); }
-	| ArrayType { $$ = std::move($1); }
-	| SliceType { $$ = std::move($1); }
-	| StructType { $$ = std::move($1); }
-	| UnionType { $$ = std::move($1); }
+	: TypeName { $$ = $1; }
+	| QualifiedTypeName { $$ = $1; }
+	| TypeInstantiation { $$ = $1; }
+	| ArrayType { $$ = $1; }
+	| SliceType { $$ = $1; }
+	| StructType { $$ = $1; }
+	| UnionType { $$ = $1; }
 	;
 
 NEFieldAssignmentList : XFieldAssignmentList MaybeComma {
-	$$ = std::move($1);
+	$$ = drv.tree().close_list($1);
 };
 
 XFieldAssignmentList : FieldAssignment {
-	$$.push_back(std::move($1));
+	$$ = drv.tree().open_list();
+	drv.tree().push($1);
 };
 
 XFieldAssignmentList: XFieldAssignmentList "," FieldAssignment {
-	$$ = std::move($1);
-	$$.push_back(std::move($3));
+	$$ = $1;
+	drv.tree().push($3);
 };
 
 FieldAssignment : LOWER_ID ":" Expression {
-	$$ = AST::FieldAssignment(std::move($1), std::move($3));
+	auto &tree = drv.tree();
+	$$ = tree.add(AST::Kind::FIELD_ASSIGNMENT, tree.add_name($1), $3);
 };
 
 NETypeList : XTypeList MaybeComma {
-	$$ = std::move($1);
+	$$ = drv.tree().close_list($1);
 };
 
 XTypeList : Type {
-	$$.push_back(std::move($1));
+	$$ = drv.tree().open_list();
+	drv.tree().push($1);
 };
 
 XTypeList : XTypeList "," Type {
-	$$ = std::move($1);
-	$$.push_back(std::move($3));
+	$$ = $1;
+	drv.tree().push($3);
 };
 
 TypeArg
@@ -854,117 +799,121 @@ XTypeArgList
 	;
 
 Type
-	: TypeName { $$ = std::move($1); }
-	| QualifiedTypeName { $$ = std::move($1); }
-	| TypeInstantiation { $$ = std::move($1); }
-	| ArrayType { $$ = std::move($1); }
-	| SliceType { $$ = std::move($1); }
-	| RawSliceType { $$ = std::move($1); }
-	| PointerType { $$ = std::move($1); }
-	| FunctionType { $$ = std::move($1); }
-	| StructType { $$ = std::move($1); }
-	| UnionType { $$ = std::move($1); }
-	| InterfaceType { $$ = std::move($1); }
+	: TypeName { $$ = $1; }
+	| QualifiedTypeName { $$ = $1; }
+	| TypeInstantiation { $$ = $1; }
+	| ArrayType { $$ = $1; }
+	| SliceType { $$ = $1; }
+	| RawSliceType { $$ = $1; }
+	| PointerType { $$ = $1; }
+	| FunctionType { $$ = $1; }
+	| StructType { $$ = $1; }
+	| UnionType { $$ = $1; }
+	| InterfaceType { $$ = $1; }
 	;
 
 TypeName : UPPER_ID {
-	$$ = std::make_unique<AST::TypeName>(std::move($1));
+	auto &tree = drv.tree();
+	$$ = tree.add_type(AST::Kind::TYPE_NAME, tree.add_name($1));
 };
 
 QualifiedTypeName : UPPER_ID "." UPPER_ID {
- 	$$ = std::make_unique<AST::QualifiedTypeName>(
- 		std::move($1),
- 		std::move($3)
+	auto &tree = drv.tree();
+	$$ = tree.add_type(
+		AST::Kind::QUALIFIED_TYPE_NAME,
+		tree.add_name($1),
+		tree.add_name($3)
 	);
 };
 
 TypeInstantiation : Type "[" NETypeList "]" {
-	$$ = std::make_unique<AST::TypeInstantiation>(
-		std::move($1),
-		std::move($3)
-	);
+	$$ = drv.tree().add_type(AST::Kind::TYPE_INSTANTIATION, $1, $3);
 };
 
 ArrayType : Type "[" Expression "]" {
-	$$ = std::make_unique<AST::ArrayType>(std::move($1), std::move($3));
+	$$ = drv.tree().add_type(AST::Kind::ARRAY_TYPE, $1, $3);
 };
 
 SliceType : Type "[" "]" {
-	$$ = std::make_unique<AST::SliceType>(std::move($1));
+	$$ = drv.tree().add_type(AST::Kind::SLICE_TYPE, $1);
 };
 
 RawSliceType : Type "[" "_" "]"	{
-	$$ = std::make_unique<AST::RawSliceType>(std::move($1));
+	$$ = drv.tree().add_type(AST::Kind::RAW_SLICE_TYPE, $1);
 };
 
 PointerType : Type "?" {
-	$$ = std::make_unique<AST::PointerType>(std::move($1));
+	$$ = drv.tree().add_type(AST::Kind::POINTER_TYPE, $1);
 };
 
 FunctionType : "func" "(" NETypeList ")" {
-	$$ = std::make_unique<AST::FunctionType>(std::move($3));
+	$$ = drv.tree().add_type(AST::Kind::FUNCTION_TYPE, $3, AST::Tree::empty_list);
 };
 
 FunctionType : "func" "(" NETypeList ")" "->" "(" NETypeList ")" {
-	$$ = std::make_unique<AST::FunctionType>(std::move($3), std::move($7));
+	$$ = drv.tree().add_type(AST::Kind::FUNCTION_TYPE, $3, $7);
 };
 
 StructType : "struct" "{" FieldList "}" {
-	$$ = std::make_unique<AST::StructType>(std::move($3));
+	$$ = drv.tree().add(AST::Kind::STRUCT_TYPE, $3);
 };
 
 UnionType :  "union" "{" FieldList "}" {
-	$$ = std::make_unique<AST::UnionType>(std::move($3));
+	$$ = drv.tree().add(AST::Kind::UNION_TYPE, $3);
 };
 
 InterfaceType : "interface" "{" InterfaceItems "}" {
 	// TODO
+	$$ = drv.tree().add(AST::Kind::INTERFACE_TYPE);
 };
 
 ExpressionList : %empty {
-	// $$ was default constructed.
+	$$ = AST::Tree::empty_list;
 };
 
 ExpressionList : XExpressionList MaybeComma {
-	$$ = std::move($1);
+	$$ = drv.tree().close_list($1);
 };
 
 NEExpressionList : XExpressionList MaybeComma {
-	$$ = std::move($1);
+	$$ = drv.tree().close_list($1);
 };
 
 XExpressionList	: Expression {
-	$$.push_back(std::move($1));
+	$$ = drv.tree().open_list();
+	drv.tree().push($1);
 };
 
 XExpressionList : XExpressionList "," Expression {
-	$$ = std::move($1);
-	$$.push_back(std::move($3));
+	$$ = $1;
+	drv.tree().push($3);
 };
 
 FieldList : %empty {
-	// $$ was default constructed.
+	$$ = AST::Tree::empty_list;
 };
 
 FieldList : XFieldList MaybeSemi {
-	$$ = std::move($1);
+	$$ = drv.tree().close_list($1);
 };
 
 XFieldList : Field {
-	$$.push_back(std::move($1));
+	$$ = drv.tree().open_list();
+	drv.tree().push($1);
 };
 
 XFieldList : XFieldList ";" Field {
-	$$ = std::move($1);
-	$$.push_back(std::move($3));
+	$$ = $1;
+	drv.tree().push($3);
 };
 
 Field : Type {
-	$$ = AST::Field(std::move($1));
+	$$ = drv.tree().add(AST::Kind::FIELD, AST::none, $1);
 };
 
 Field : LOWER_ID Type {
-	$$ = AST::Field(std::move($1), std::move($2));
+	auto &tree = drv.tree();
+	$$ = tree.add(AST::Kind::FIELD, tree.add_name($1), $2);
 };
 
 InterfaceItems
@@ -990,6 +939,6 @@ MaybeSemi
 
 %%
 
-void yy::Parser::error(const yy::location& l, const std::string& m) {
-	std::cerr << l << ": " << m << std::endl;
+void yy::Parser::error(const Primordial::Location& l, const std::string& m) {
+	drv.syntax_error(l, m);
 }
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "source.hpp"
+
+namespace Primordial {
+
+	// Initial buffer size when reading from a file descriptor.
+	static constexpr std::size_t initial_read_size = 64 * 1024;
+
+	// Closes a file descriptor when going out of scope.
+	class FileDescriptor {
+	public:
+		explicit FileDescriptor(int fd) : fd_(fd) {}
+
+		~FileDescriptor() {
+			if (fd_ >= 0) {
+				::close(fd_);
+			}
+		}
+
+		FileDescriptor(FileDescriptor const &) = delete;
+		FileDescriptor& operator=(FileDescriptor const &) = delete;
+
+		auto get() const -> int {
+			return fd_;
+		}
+
+	private:
+		int fd_;
+	};
+
+	[[noreturn]] static void throw_errno(std::string const &what) {
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+
+	static void check_size(std::size_t size, std::string const &what) {
+		if (size > Source::max_size) {
+			throw std::length_error(what + ": source too large");
+		}
+	}
+
+	auto Source::map(std::string const &path) -> std::unique_ptr<Source> {
+		FileDescriptor fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+		if (fd.get() < 0) {
+			throw_errno(path);
+		}
+
+		struct stat st;
+		if (::fstat(fd.get(), &st) < 0) {
+			throw_errno(path);
+		}
+
+		if (!S_ISREG(st.st_mode)) {
+			return read(fd.get());
+		}
+
+		check_size(static_cast<std::size_t>(st.st_size), path);
+		auto source = std::unique_ptr<Source>(new Source());
+		source->size_ = static_cast<std::size_t>(st.st_size);
+
+		// Reserve room for the text and the NULs with an anonymous mapping
+		// and map the file over its start. Whatever lies past the end of
+		// the file is zero-filled, even if the file size is a multiple of
+		// the page size. MAP_PRIVATE keeps the writes of flex private.
+		void *p = ::mmap(
+			nullptr,
+			source->size_ + 2,
+			PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS,
+			-1,
+			0
+		);
+		if (p == MAP_FAILED) {
+			throw_errno(path);
+		}
+
+		// From here on, the destructor releases the mapping on failure.
+		source->data_ = static_cast<char *>(p);
+		source->mapping_size_ = source->size_ + 2;
+		if (source->size_ == 0) {
+			return source;
+		}
+
+		p = ::mmap(
+			p,
+			source->size_,
+			PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_FIXED,
+			fd.get(),
+			0
+		);
+		if (p == MAP_FAILED) {
+			throw_errno(path);
+		}
+
+		return source;
+	}
+
+	auto Source::head(
+		std::string const &path,
+		std::size_t size
+	) -> std::unique_ptr<Source> {
+		FileDescriptor fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+		if (fd.get() < 0) {
+			throw_errno(path);
+		}
+
+		// One more byte tells whether there is more.
+		auto source = read(fd.get(), size + 1);
+		if (source->size_ > size) {
+			source->buffer_.resize(size);
+			source->buffer_.resize(size + 2);
+			source->data_ = source->buffer_.data();
+			source->size_ = size;
+			source->truncated_ = true;
+		}
+
+		check_size(source->size_, path);
+		return source;
+	}
+
+	auto Source::read(int fd) -> std::unique_ptr<Source> {
+		// One more byte tells whether the input is too large.
+		auto source = read(fd, max_size + 1);
+		check_size(source->size_, "read");
+		return source;
+	}
+
+	auto Source::read(int fd, std::size_t limit) -> std::unique_ptr<Source> {
+		auto source = std::unique_ptr<Source>(new Source());
+		auto &buffer = source->buffer_;
+		buffer.resize(std::min(initial_read_size, limit));
+
+		std::size_t size = 0;
+		while (size < limit) {
+			if (size == buffer.size()) {
+				buffer.resize(std::min(2 * buffer.size(), limit));
+			}
+
+			auto n = ::read(fd, buffer.data() + size, buffer.size() - size);
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+
+				throw_errno("read");
+			}
+
+			if (n == 0) {
+				break;
+			}
+
+			size += static_cast<std::size_t>(n);
+		}
+
+		// Shrinking keeps the capacity, so this only writes the NULs.
+		buffer.resize(size);
+		buffer.resize(size + 2);
+		source->data_ = buffer.data();
+		source->size_ = size;
+		return source;
+	}
+
+	auto Source::copy(std::string_view text) -> std::unique_ptr<Source> {
+		check_size(text.size(), "copy");
+		auto source = std::unique_ptr<Source>(new Source());
+		auto &buffer = source->buffer_;
+		buffer.reserve(text.size() + 2);
+		buffer.assign(text);
+		buffer.resize(text.size() + 2);
+		source->data_ = buffer.data();
+		source->size_ = text.size();
+		return source;
+	}
+
+	Source::~Source() {
+		if (mapping_size_ != 0) {
+			::munmap(data_, mapping_size_);
+		}
+	}
+
+	auto Source::text() const -> std::string_view {
+		return std::string_view(data_, size_);
+	}
+
+	auto Source::truncated() const -> bool {
+		return truncated_;
+	}
+
+	auto Source::scan_buffer() -> char * {
+		return data_;
+	}
+
+	auto Source::scan_buffer_size() const -> std::size_t {
+		return size_ + 2;
+	}
+
+} // namespace Primordial
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Primordial {
+
+	// Contents of a source file.
+	//
+	// The text is followed by the two NUL bytes that flex needs to scan a
+	// buffer in place, so the lexer can work on it without copying and
+	// tokens can refer to it with string_views for as long as the source
+	// is alive. Flex temporarily writes into the buffer while scanning,
+	// which is why it is not const.
+	//
+	// Locations are 32-bit offsets that must also reach past the end of the
+	// text, so every constructor throws std::length_error for texts longer
+	// than max_size.
+	class Source {
+	public:
+		static constexpr std::size_t max_size = UINT32_MAX - 2;
+
+		// Map a file into memory.
+		//
+		// Throws std::system_error if the file cannot be opened or mapped.
+		static auto map(std::string const &path) -> std::unique_ptr<Source>;
+
+		// Read a file descriptor until EOF. Used for pipes and terminals,
+		// which cannot be mapped.
+		//
+		// Throws std::system_error on read errors.
+		static auto read(int fd) -> std::unique_ptr<Source>;
+
+		// Read at most size bytes from the start of a file, for parses that
+		// only need its head.
+		//
+		// Throws std::system_error if the file cannot be read.
+		static auto head(std::string const &path, std::size_t size)
+			-> std::unique_ptr<Source>;
+
+		// Copy a part of another text, such as a function body.
+		static auto copy(std::string_view text) -> std::unique_ptr<Source>;
+
+		~Source();
+
+		Source(Source const &) = delete;
+		Source& operator=(Source const &) = delete;
+
+		auto text() const -> std::string_view;
+
+		// Whether the text is only the head of a longer file.
+		auto truncated() const -> bool;
+
+		// Buffer for yy_scan_buffer, including the trailing NULs.
+		auto scan_buffer() -> char *;
+		auto scan_buffer_size() const -> std::size_t;
+
+	private:
+		Source() = default;
+
+		static auto read(int fd, std::size_t limit) -> std::unique_ptr<Source>;
+
+		char *data_ = nullptr;
+		std::size_t size_ = 0;
+
+		// Size of the mapping, or zero if the data lives in buffer_.
+		std::size_t mapping_size_ = 0;
+		std::string buffer_;
+		bool truncated_ = false;
+	};
+
+} // namespace Primordial
@@ -0,0 +1,146 @@
+#include <cstdio>
+#include "stats.hpp"
+#include "parser.hpp"
+
+namespace Primordial {
+
+	static auto kind_string(AST::Kind kind) -> std::string_view {
+		switch (kind) {
+			case AST::Kind::TYPE_NAME: return "TYPE_NAME";
+			case AST::Kind::QUALIFIED_TYPE_NAME: return "QUALIFIED_TYPE_NAME";
+			case AST::Kind::TYPE_INSTANTIATION: return "TYPE_INSTANTIATION";
+			case AST::Kind::ARRAY_TYPE: return "ARRAY_TYPE";
+			case AST::Kind::SLICE_TYPE: return "SLICE_TYPE";
+			case AST::Kind::RAW_SLICE_TYPE: return "RAW_SLICE_TYPE";
+			case AST::Kind::POINTER_TYPE: return "POINTER_TYPE";
+			case AST::Kind::FUNCTION_TYPE: return "FUNCTION_TYPE";
+			case AST::Kind::FIELD: return "FIELD";
+			case AST::Kind::STRUCT_TYPE: return "STRUCT_TYPE";
+			case AST::Kind::UNION_TYPE: return "UNION_TYPE";
+			case AST::Kind::INTERFACE_TYPE: return "INTERFACE_TYPE";
+			case AST::Kind::BINARY_EXPRESSION: return "BINARY_EXPRESSION";
+			case AST::Kind::UNARY_EXPRESSION: return "UNARY_EXPRESSION";
+			case AST::Kind::BOOLEAN_LITERAL: return "BOOLEAN_LITERAL";
+			case AST::Kind::STRING_LITERAL: return "STRING_LITERAL";
+			case AST::Kind::NUMERIC_LITERAL: return "NUMERIC_LITERAL";
+			case AST::Kind::EMPTY_COMPOUND_LITERAL:
+				return "EMPTY_COMPOUND_LITERAL";
+			case AST::Kind::LIST_LITERAL: return "LIST_LITERAL";
+			case AST::Kind::FIELD_ASSIGNMENT: return "FIELD_ASSIGNMENT";
+			case AST::Kind::RECORD_LITERAL: return "RECORD_LITERAL";
+			case AST::Kind::ARRAY_ACCESS: return "ARRAY_ACCESS";
+			case AST::Kind::FIELD_ACCESS: return "FIELD_ACCESS";
+			case AST::Kind::PACKAGE_ACCESS: return "PACKAGE_ACCESS";
+			case AST::Kind::SYMBOL_ACCESS: return "SYMBOL_ACCESS";
+			case AST::Kind::POINTER_DEREFERENCE: return "POINTER_DEREFERENCE";
+			case AST::Kind::TYPE_CAST: return "TYPE_CAST";
+			case AST::Kind::IMPORT: return "IMPORT";
+			case AST::Kind::FILE: return "FILE";
+		}
+
+		return "UNKNOWN";
+	}
+
+	static void write_string(std::ostream &os, std::string_view s) {
+		os << '"';
+		for (char c : s) {
+			if (c == '"' || c == '\\') {
+				os << '\\' << c;
+			} else if (static_cast<unsigned char>(c) < 0x20) {
+				char escape[8];
+				std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+				os << escape;
+			} else {
+				os << c;
+			}
+		}
+
+		os << '"';
+	}
+
+	static void write_ns(std::ostream &os, Stats::Duration d) {
+		os << std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+	}
+
+	void Stats::count_nodes(AST::Tree const &tree) {
+		for (AST::NodeId id = 0; id < tree.size(); ++id) {
+			auto kind = static_cast<std::size_t>(tree.kind(id));
+			if (kind >= nodes.size()) {
+				nodes.resize(kind + 1);
+			}
+
+			++nodes[kind];
+		}
+	}
+
+	void Stats::write_json(
+		std::ostream &os,
+		std::string_view path,
+		int status
+	) const {
+		std::size_t total_tokens = 0;
+		for (auto n : tokens) {
+			total_tokens += n;
+		}
+
+		std::size_t total_nodes = 0;
+		for (auto n : nodes) {
+			total_nodes += n;
+		}
+
+		os << "{\"path\":";
+		write_string(os, path);
+		os << ",\"status\":" << status;
+		os << ",\"bytes\":" << bytes;
+		os << ",\"tokens\":" << total_tokens;
+		os << ",\"tokens_by_kind\":{";
+
+		// Only the kinds that appear, named as in parser errors.
+		bool first = true;
+		for (std::size_t kind = 0; kind < tokens.size(); ++kind) {
+			if (tokens[kind] == 0) {
+				continue;
+			}
+
+			if (!first) {
+				os << ',';
+			}
+
+			first = false;
+			auto symbol = static_cast<yy::Parser::symbol_kind_type>(kind);
+			write_string(os, yy::Parser::symbol_name(symbol));
+			os << ':' << tokens[kind];
+		}
+
+		os << "},\"nodes\":" << total_nodes;
+		os << ",\"nodes_by_kind\":{";
+		first = true;
+		for (std::size_t kind = 0; kind < nodes.size(); ++kind) {
+			if (nodes[kind] == 0) {
+				continue;
+			}
+
+			if (!first) {
+				os << ',';
+			}
+
+			first = false;
+			write_string(os, kind_string(static_cast<AST::Kind>(kind)));
+			os << ':' << nodes[kind];
+		}
+
+		os << "},\"max_stack_depth\":" << max_stack_depth;
+		os << ",\"allocations\":" << allocations;
+		os << ",\"allocated_bytes\":" << allocated_bytes;
+		os << ",\"ns\":{\"lex\":";
+		write_ns(os, lex);
+		os << ",\"parse\":";
+		write_ns(os, parse);
+		os << ",\"print\":";
+		write_ns(os, print);
+		os << ",\"teardown\":";
+		write_ns(os, teardown);
+		os << "}}\n";
+	}
+
+} // namespace Primordial
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include "ast.hpp"
+
+namespace Primordial {
+
+	// Statistics about the parse of a file, used to find pathological
+	// inputs in a corpus.
+	//
+	// A Driver only collects them while it has a Stats object, so parses
+	// without statistics do not pay for them. The phases that happen
+	// outside of the driver, such as printing, are filled in by its user.
+	struct Stats {
+		using Duration = std::chrono::steady_clock::duration;
+
+		std::size_t bytes = 0;
+
+		// Tokens indexed by their symbol kind in the parser.
+		std::vector<std::size_t> tokens;
+
+		// Nodes of the tree indexed by their kind.
+		std::vector<std::size_t> nodes;
+
+		// Largest number of symbols on the parser stack.
+		std::size_t max_stack_depth = 0;
+
+		// Heap allocations of all the phases.
+		std::size_t allocations = 0;
+		std::size_t allocated_bytes = 0;
+
+		// Lexing is interleaved with parsing, and its time is not included
+		// in the parse time.
+		Duration lex{};
+		Duration parse{};
+		Duration print{};
+		Duration teardown{};
+
+		void count_token(std::size_t kind) {
+			if (kind >= tokens.size()) {
+				tokens.resize(kind + 1);
+			}
+
+			++tokens[kind];
+		}
+
+		void sample_stack_depth(std::size_t depth) {
+			max_stack_depth = std::max(max_stack_depth, depth);
+		}
+
+		void count_nodes(AST::Tree const &tree);
+
+		// Write the statistics as a JSON object on a single line, so that
+		// the statistics of many files can be processed as JSON Lines.
+		void write_json(
+			std::ostream &os,
+			std::string_view path,
+			int status
+		) const;
+	};
+
+} // namespace Primordial
@@ -0,0 +1,9 @@
+package Example
+
+func ok() {
+	x := 1
+}
+
+func bad() {
+	x := 1 +
+}
@@ -0,0 +1,5 @@
+package Example
+
+# Only declarations can have type parameters without constraints.
+func map[T, U](xs T[]) {
+}
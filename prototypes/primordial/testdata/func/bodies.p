@@ -0,0 +1,35 @@
+package Example
+
+import "fmt"
+
+# Braces in strings and comments do not end the bodies.
+func greet(name String) {
+	fmt.printf("{%s}\n", name)  # }
+	if name == "}" {
+		x := "{"
+	}
+}
+
+func apply(f func(Int) -> (Int), g struct { x Int }) -> (Int) {
+	let y = func(x Int) { z := x }
+	while true {
+		{
+			break
+		}
+	}
+}
+
+func (s Stack) push(x Int) {
+	s.items = s.items
+}
+
+func map[T Any, U Any](xs T[]) {}
+
+func declared(x Int)
+
+let callback func(Int) = nothing
+
+type Pair struct {
+	first Int
+	second Int
+}
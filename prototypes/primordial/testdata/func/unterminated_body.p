@@ -0,0 +1,5 @@
+package Example
+
+func f() {
+	if x {
+	}
@@ -0,0 +1,166 @@
+# OK
+# The imports go on past the first read of a prescan.
+package Example
+
+import "example/imports/package001"
+import "example/imports/package002"
+import "example/imports/package003"
+import "example/imports/package004"
+import "example/imports/package005"
+import "example/imports/package006"
+import "example/imports/package007"
+import "example/imports/package008"
+import "example/imports/package009"
+import "example/imports/package010"
+import "example/imports/package011"
+import "example/imports/package012"
+import "example/imports/package013"
+import "example/imports/package014"
+import "example/imports/package015"
+import "example/imports/package016"
+import "example/imports/package017"
+import "example/imports/package018"
+import "example/imports/package019"
+import "example/imports/package020"
+import "example/imports/package021"
+import "example/imports/package022"
+import "example/imports/package023"
+import "example/imports/package024"
+import "example/imports/package025"
+import "example/imports/package026"
+import "example/imports/package027"
+import "example/imports/package028"
+import "example/imports/package029"
+import "example/imports/package030"
+import "example/imports/package031"
+import "example/imports/package032"
+import "example/imports/package033"
+import "example/imports/package034"
+import "example/imports/package035"
+import "example/imports/package036"
+import "example/imports/package037"
+import "example/imports/package038"
+import "example/imports/package039"
+import "example/imports/package040"
+import "example/imports/package041"
+import "example/imports/package042"
+import "example/imports/package043"
+import "example/imports/package044"
+import "example/imports/package045"
+import "example/imports/package046"
+import "example/imports/package047"
+import "example/imports/package048"
+import "example/imports/package049"
+import "example/imports/package050"
+import "example/imports/package051"
+import "example/imports/package052"
+import "example/imports/package053"
+import "example/imports/package054"
+import "example/imports/package055"
+import "example/imports/package056"
+import "example/imports/package057"
+import "example/imports/package058"
+import "example/imports/package059"
+import "example/imports/package060"
+import "example/imports/package061"
+import "example/imports/package062"
+import "example/imports/package063"
+import "example/imports/package064"
+import "example/imports/package065"
+import "example/imports/package066"
+import "example/imports/package067"
+import "example/imports/package068"
+import "example/imports/package069"
+import "example/imports/package070"
+import "example/imports/package071"
+import "example/imports/package072"
+import "example/imports/package073"
+import "example/imports/package074"
+import "example/imports/package075"
+import "example/imports/package076"
+import "example/imports/package077"
+import "example/imports/package078"
+import "example/imports/package079"
+import "example/imports/package080"
+import "example/imports/package081"
+import "example/imports/package082"
+import "example/imports/package083"
+import "example/imports/package084"
+import "example/imports/package085"
+import "example/imports/package086"
+import "example/imports/package087"
+import "example/imports/package088"
+import "example/imports/package089"
+import "example/imports/package090"
+import "example/imports/package091"
+import "example/imports/package092"
+import "example/imports/package093"
+import "example/imports/package094"
+import "example/imports/package095"
+import "example/imports/package096"
+import "example/imports/package097"
+import "example/imports/package098"
+import "example/imports/package099"
+import "example/imports/package100"
+import "example/imports/package101"
+import "example/imports/package102"
+import "example/imports/package103"
+import "example/imports/package104"
+import "example/imports/package105"
+import "example/imports/package106"
+import "example/imports/package107"
+import "example/imports/package108"
+import "example/imports/package109"
+import "example/imports/package110"
+import "example/imports/package111"
+import "example/imports/package112"
+import "example/imports/package113"
+import "example/imports/package114"
+import "example/imports/package115"
+import "example/imports/package116"
+import "example/imports/package117"
+import "example/imports/package118"
+import "example/imports/package119"
+import "example/imports/package120"
+import "example/imports/package121"
+import "example/imports/package122"
+import "example/imports/package123"
+import "example/imports/package124"
+import "example/imports/package125"
+import "example/imports/package126"
+import "example/imports/package127"
+import "example/imports/package128"
+import "example/imports/package129"
+import "example/imports/package130"
+import "example/imports/package131"
+import "example/imports/package132"
+import "example/imports/package133"
+import "example/imports/package134"
+import "example/imports/package135"
+import "example/imports/package136"
+import "example/imports/package137"
+import "example/imports/package138"
+import "example/imports/package139"
+import "example/imports/package140"
+import "example/imports/package141"
+import "example/imports/package142"
+import "example/imports/package143"
+import "example/imports/package144"
+import "example/imports/package145"
+import "example/imports/package146"
+import "example/imports/package147"
+import "example/imports/package148"
+import "example/imports/package149"
+import "example/imports/package150"
+import "example/imports/package151"
+import "example/imports/package152"
+import "example/imports/package153"
+import "example/imports/package154"
+import "example/imports/package155"
+import "example/imports/package156"
+import "example/imports/package157"
+import "example/imports/package158"
+import "example/imports/package159"
+import "example/imports/package160"
+
+let x = true
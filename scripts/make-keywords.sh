@@ -0,0 +1,131 @@
+#!/bin/sh
+# Generate a perfect hash table for the keywords of the scanner.
+#
+# Usage: make-keywords.sh keywords.txt > keywords.S
+#
+# The input has one keyword and its token type per line. Empty lines and
+# lines starting with # are ignored.
+#
+# Keywords are hashed on their first byte, their middle byte and their
+# size:
+#
+#   hash = ((first << KEYWORD_SHIFT_FIRST)
+#        + (middle << KEYWORD_SHIFT_MIDDLE)
+#        + (size << KEYWORD_SHIFT_SIZE)) & KEYWORD_MASK
+#
+# where middle is the byte at index size / 2, so that identifiers of any
+# size can be hashed without reading past their end. This script searches
+# for the smallest table and the shifts that give every keyword its own
+# slot, so that looking up an identifier needs a single probe and a single
+# comparison. The build fails if there is no such table.
+set -eu
+
+awk '
+BEGIN {
+	for (i = 1; i < 256; ++i) {
+		ord[sprintf("%c", i)] = i
+	}
+}
+
+/^[ \t]*(#|$)/ {
+	next
+}
+
+{
+	if (NF != 2 || $1 !~ /^[_a-z][_a-z0-9]*$/) {
+		printf "%s:%d: invalid keyword\n", FILENAME, FNR > "/dev/stderr"
+		exit 1
+	}
+
+	n++
+	word[n] = $1
+	token[n] = $2
+}
+
+function hash(w, a, b, c, size,    len) {
+	len = length(w)
+	return (ord[substr(w, 1, 1)] * 2 ^ a \
+		+ ord[substr(w, int(len / 2) + 1, 1)] * 2 ^ b \
+		+ len * 2 ^ c) % size
+}
+
+# Try to assign a slot to every keyword.
+function place(a, b, c, size,    i, h) {
+	split("", slot)
+	for (i = 1; i <= n; ++i) {
+		h = hash(word[i], a, b, c, size)
+		if (h in slot) {
+			return 0
+		}
+
+		slot[h] = i
+	}
+
+	return 1
+}
+
+END {
+	if (n == 0) {
+		print "no keywords" > "/dev/stderr"
+		exit 1
+	}
+
+	for (size = 1; size < n; size *= 2) {
+	}
+
+	for (; size <= 1024; size *= 2) {
+		for (a = 0; a < 8; ++a) {
+			for (b = 0; b < 8; ++b) {
+				for (c = 0; c < 8; ++c) {
+					if (place(a, b, c, size)) {
+						emit(a, b, c, size)
+						exit 0
+					}
+				}
+			}
+		}
+	}
+
+	print "no perfect hash found for the keywords" > "/dev/stderr"
+	exit 1
+}
+
+function emit(a, b, c, size,    i) {
+	print "# Generated by scripts/make-keywords.sh. Do not edit."
+	print ""
+	print "#include <compat.S>"
+	print "#include <safe_str.S>"
+	print "#include <slice.S>"
+	print ""
+	printf ".equiv KEYWORD_SHIFT_FIRST, %d\n", a
+	printf ".equiv KEYWORD_SHIFT_MIDDLE, %d\n", b
+	printf ".equiv KEYWORD_SHIFT_SIZE, %d\n", c
+	printf ".equiv KEYWORD_MASK, %d\n", size - 1
+	print ""
+	print ".section .rodata"
+	print ""
+	print "# Keyword of every slot, or an empty slice if the slot is free."
+	print "Xalign"
+	print "keyword_slots:"
+	for (i = 0; i < size; ++i) {
+		if (i in slot) {
+			printf "safe_str_slice keyword_%s\n", word[slot[i]]
+		} else {
+			print "Xbyte 0"
+			print "Xbyte 0"
+		}
+	}
+
+	print ""
+	print "# Token type of every slot."
+	print "keyword_tokens:"
+	for (i = 0; i < size; ++i) {
+		printf ".byte %s\n", i in slot ? token[slot[i]] : 0
+	}
+
+	print ""
+	for (i = 1; i <= n; ++i) {
+		printf "safe_str keyword_%s, \"%s\"\n", word[i], word[i]
+	}
+}
+' "$1"
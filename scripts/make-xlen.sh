@@ -23,6 +23,14 @@ fi
 BUILD_ROOT="${BUILD_ROOT:-build}/${XLEN}"
 NO_TEST="${NO_TEST:-}"
 
+# Set to also run the benchmarks of every test suite. The results of each
+# suite are written next to its executable, with the .bench extension.
+BENCH="${BENCH:-}"
+
+# Set to build the kernels that use the vector extension (RVV). The tests
+# then need a CPU that implements it, such as QEMU_CPU=max under QEMU.
+VECTOR="${VECTOR:-}"
+
 # Even if we only use assembler, it still needs a compiler (gcc).
 # -T enhances, rather than replaces, the linker script.
 AS="${AS:-riscv${XLEN}-unknown-elf-gcc}"
@@ -32,9 +40,11 @@ ASFLAGS="${ASFLAGS:-
 	-Wa,--fatal-warnings
 	-Wl,-Tlinker.ld
 	-Iinc
+	-I${BUILD_ROOT}/gen
 	-mcmodel=medlow
 	-nostdlib
 	-static
+	${VECTOR:+-march=rv${XLEN}gcv}
 }"
 
 # ===========================================================================
@@ -107,6 +117,18 @@ assemble() {
 	"$AS" $ASFLAGS -c -o "$target" "$source"
 }
 
+generate() {
+	target="$BUILD_ROOT/$1"
+	shift
+
+	info "Generating $target ..."
+
+	target_dir="$(dirname "$target")"
+	mkdir -p "$target_dir"
+
+	"$@" >"$target"
+}
+
 build_library() {
 	target="$BUILD_ROOT/$1"
 	shift
@@ -182,6 +204,13 @@ with_test() {
 			die "Approval testing of $target failed!"
 		fi
 	fi
+
+	if [ -n "$BENCH" ]; then
+		info "Running benchmarks of $target ..."
+		if ! "$target" -bench <"${input}" >"$target.bench"; then
+			die "Benchmarks of $target failed!"
+		fi
+	fi
 }
 
 sanity_check() {
@@ -259,11 +288,14 @@ assemble lib/p0/format/space.S
 assemble lib/p0/format/string.S
 assemble lib/p0/format/unsigned.S
 assemble lib/p0/io/read.S
+assemble lib/p0/io/readall.S
 assemble lib/p0/io/write.S
+assemble lib/p0/io/writer.S
 assemble lib/p0/os/exit.S
 assemble lib/p0/mem/eq.S
 assemble lib/p0/mem/index.S
 assemble lib/p0/mem/shortlex.S
+assemble lib/p0/strintern/hashtable.S
 assemble lib/p0/strintern/strintern.S
 
 build_library lib/libp0.a \
@@ -275,13 +307,16 @@ build_library lib/libp0.a \
 	"$BUILD_ROOT/lib/p0/format/string.o" \
 	"$BUILD_ROOT/lib/p0/format/unsigned.o" \
 	"$BUILD_ROOT/lib/p0/io/read.o" \
+	"$BUILD_ROOT/lib/p0/io/readall.o" \
 	"$BUILD_ROOT/lib/p0/io/write.o" \
+	"$BUILD_ROOT/lib/p0/io/writer.o" \
 	"$BUILD_ROOT/lib/p0/os/exit.o" \
 	"$BUILD_ROOT/lib/p0/mem/clone.o" \
 	"$BUILD_ROOT/lib/p0/mem/copy.o" \
 	"$BUILD_ROOT/lib/p0/mem/eq.o" \
 	"$BUILD_ROOT/lib/p0/mem/index.o" \
 	"$BUILD_ROOT/lib/p0/mem/shortlex.o" \
+	"$BUILD_ROOT/lib/p0/strintern/hashtable.o" \
 	"$BUILD_ROOT/lib/p0/strintern/strintern.o"
 
 section Test the p0 library.
@@ -291,6 +326,9 @@ with_test lib/p0/ascii/ascii_test \
 with_test lib/p0/forever/allocate_test \
 	"$BUILD_ROOT/lib/libp0.a"
 
+with_test lib/p0/forever/allocate_internal_test \
+	"$BUILD_ROOT/lib/libp0.a"
+
 with_test lib/p0/format/newline_test \
 	"$BUILD_ROOT/lib/libp0.a"
 
@@ -309,9 +347,15 @@ with_test lib/p0/format/unsigned_test \
 with_test lib/p0/io/read_test \
 	"$BUILD_ROOT/lib/libp0.a"
 
+with_test lib/p0/io/readall_internal_test \
+	"$BUILD_ROOT/lib/libp0.a"
+
 with_test lib/p0/io/write_test \
 	"$BUILD_ROOT/lib/libp0.a"
 
+with_test lib/p0/io/writer_test \
+	"$BUILD_ROOT/lib/libp0.a"
+
 with_test lib/p0/mem/clone_test \
 	"$BUILD_ROOT/lib/libp0.a"
 
@@ -330,6 +374,9 @@ with_test lib/p0/mem/shortlex_test \
 with_test lib/p0/strintern/strintern_internal_test \
 	"$BUILD_ROOT/lib/libp0.a"
 
+with_test lib/p0/strintern/hashtable_internal_test \
+	"$BUILD_ROOT/lib/libp0.a"
+
 section Build a simple program that uses the p0 library.
 assemble cmd/hello/hello.S
 
@@ -340,6 +387,9 @@ build_executable cmd/hello/hello \
 sanity_check "$BUILD_ROOT/cmd/hello/hello"
 
 section Build the Primordial compiler
+generate gen/compile/keywords.S \
+	scripts/make-keywords.sh cmd/compile/scanner/keywords.txt
+
 assemble cmd/compile/scanner/scan.S
 
 with_test cmd/compile/scanner/scan_test \